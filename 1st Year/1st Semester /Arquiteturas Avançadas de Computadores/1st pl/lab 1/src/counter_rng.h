@@ -0,0 +1,45 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+// Counter-based random numbers (SplitMix64 style).
+// Value number `index` of a stream is computed directly instead of advancing
+// a shared state, so any thread can generate element (u, f) on its own and
+// the data is identical for any thread count and any standard library.
+//   uint64_t key = rng_key(seed, stream);  // once per stream
+//   double x = rng_uniform(key, index);    // e.g. index = u * dim + f
+//
+// Same generator as Parallel Computing/counterRng.h (rngMix, rngKey, rngAt,
+// rngUniform), under this lab's naming. The two must stay bit-identical: the
+// static_asserts at the end pin known values that counterRng.h lists too.
+
+constexpr uint64_t RNG_GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+// SplitMix64 finalizer: mixes all bits of x
+constexpr uint64_t rng_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Key of an independent stream (e.g. one for features, one for links)
+constexpr uint64_t rng_key(uint64_t seed, uint64_t stream) {
+    return rng_mix(seed ^ rng_mix(stream * RNG_GOLDEN + RNG_GOLDEN));
+}
+
+// Value number `index` of the stream
+constexpr uint64_t rng_at(uint64_t key, uint64_t index) {
+    return rng_mix(key + (index + 1) * RNG_GOLDEN);
+}
+
+// Uniform double in [0, 1) from the top 53 bits
+constexpr double rng_uniform(uint64_t key, uint64_t index) {
+    return (double)(rng_at(key, index) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Known-answer values (same as in counterRng.h); a change here is a compile error
+static_assert(rng_at(rng_key(42, 0), 0) == 0xCA685846B557F0FCULL, "counter RNG drifted from counterRng.h");
+static_assert(rng_at(rng_key(123, 1), 1000) == 0x26A102A3AA5DBEDFULL, "counter RNG drifted from counterRng.h");
+
+#endif // COUNTER_RNG_H
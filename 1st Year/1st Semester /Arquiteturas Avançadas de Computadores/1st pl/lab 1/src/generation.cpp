@@ -1,27 +1,35 @@
 #include "generation.h"
+#include "counter_rng.h"
 #include <vector>
-#include <random>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+// Independent random streams used by the generators
+enum RngStream : uint64_t { STREAM_PARAMS, STREAM_FOLLOWS, STREAM_LINKS, STREAM_FEATURES };
 
 
 // Generates a realistic followers matrix automatically.
 // - Few super-celebs with massive followers
 // - Most users follow a random number of others
 // - Preferential attachment for rich-get-richer effect
-std::vector<std::vector<int>> generate_followers_matrix(int num_users) {
+// Preferential attachment depends on the degrees built so far, so this stays
+// sequential; every draw comes from the counter RNG, indexed by (user, attempt),
+// so a given seed always produces the same network.
+std::vector<std::vector<int>> generate_followers_matrix(int num_users, uint64_t seed) {
     std::vector<std::vector<int>> matrix(num_users, std::vector<int>(num_users, 0));
 
-    // RNG
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // RNG streams
+    const uint64_t params_key  = rng_key(seed, STREAM_PARAMS);
+    const uint64_t follows_key = rng_key(seed, STREAM_FOLLOWS);
+    const uint64_t links_key   = rng_key(seed, STREAM_LINKS);
 
-    // Randomize parameters to make each run unique but realistic
+    // Randomize parameters (different seeds give different but realistic networks)
     int initial_links       = std::max(3, num_users / 200); // small fully-connected core
     int num_supercelebs     = std::max(1, num_users / 500); // ~0.2% super celebs
-    int superceleb_weight   = 1000 + (gen() % 5000);        // huge initial weight
+    int superceleb_weight   = 1000 + (int)(rng_at(params_key, 0) % 5000); // huge initial weight
     int avg_follows_per_user = std::max(10, num_users / 100); // average follows per user
 
-    std::exponential_distribution<> follow_dist(1.0 / avg_follows_per_user);
-
     // Track degree for preferential attachment
     std::vector<int> degree(num_users, 1);
     int total_degree = num_users;
@@ -45,13 +53,16 @@ std::vector<std::vector<int>> generate_followers_matrix(int num_users) {
 
     // Add new users
     for (int u = initial_links; u < num_users; ++u) {
-        int follows_to_make = std::max(1, (int)follow_dist(gen));
+        // Exponential with mean avg_follows_per_user (inverse transform)
+        double follows = -std::log(1.0 - rng_uniform(follows_key, u)) * avg_follows_per_user;
+        int follows_to_make = std::max(1, (int)follows);
         if (follows_to_make > u) follows_to_make = u;
 
+        uint64_t attempt = (uint64_t)u << 32; // draws of user u
         while (follows_to_make > 0) {
             for (int v = 0; v < u && follows_to_make > 0; ++v) {
                 double prob = (double)degree[v] / total_degree;
-                if (std::generate_canonical<double, 10>(gen) < prob) {
+                if (rng_uniform(links_key, attempt++) < prob) {
                     if (matrix[u][v] == 0) {
                         matrix[u][v] = 1;
                         degree[v]++;
@@ -70,15 +81,30 @@ std::vector<std::vector<int>> generate_followers_matrix(int num_users) {
 
 
 
-std::vector<std::vector<double>> generate_user_features(int num_users, int feature_dim) {
+// Each feature (u, f) is value u * feature_dim + f of the features stream,
+// so threads fill disjoint blocks of users without sharing any RNG state.
+std::vector<std::vector<double>> generate_user_features(int num_users, int feature_dim,
+                                                        int num_threads, uint64_t seed) {
     std::vector<std::vector<double>> features(num_users, std::vector<double>(feature_dim));
-    std::mt19937 gen(123);
-    std::uniform_real_distribution<> dist(0.0, 1.0);
+    const uint64_t key = rng_key(seed, STREAM_FEATURES);
 
-    for (int u = 0; u < num_users; u++) {
-        for (int f = 0; f < feature_dim; f++) {
-            features[u][f] = dist(gen);
+    auto fill = [&](int first, int last) {
+        for (int u = first; u < last; u++) {
+            for (int f = 0; f < feature_dim; f++) {
+                features[u][f] = rng_uniform(key, (uint64_t)u * feature_dim + f);
+            }
         }
+    };
+
+    num_threads = std::max(1, std::min(num_threads, num_users));
+    int chunk = num_users / num_threads;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        int first = t * chunk;
+        int last  = (t == num_threads - 1) ? num_users : first + chunk;
+        threads.emplace_back(fill, first, last);
     }
+    for (auto &th : threads) th.join();
+
     return features;
 }
@@ -2,11 +2,14 @@
 #define GENERATION_H
 
 #include <vector>
+#include <cstdint>
 
-// Generate a dense followers matrix (0/1)
-std::vector<std::vector<int>> generate_followers_matrix(int num_users);
+// Generate a dense followers matrix (0/1); the same seed gives the same network
+std::vector<std::vector<int>> generate_followers_matrix(int num_users, uint64_t seed = 42);
 
 // Generate random user features [activity, likes, posts, etc.]
-std::vector<std::vector<double>> generate_user_features(int num_users, int feature_dim);
+// Users are split across num_threads threads; the result does not depend on it
+std::vector<std::vector<double>> generate_user_features(int num_users, int feature_dim,
+                                                        int num_threads = 1, uint64_t seed = 123);
 
 #endif // GENERATION_H
@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <chrono>
 #include <utility>
+#include <cstdint>
 
-#include "generation.h" // deve fornecer: generate_followers_matrix(int), generate_user_features(int,int)
+#include "generation.h" // deve fornecer: generate_followers_matrix(int, uint64_t seed),
+                        // generate_user_features(int, int, int num_threads, uint64_t seed)
 
 // ----------------------
 // Utilitários
@@ -152,17 +154,21 @@ int main(int argc, char* argv[]) {
     int feature_dim = 3;           // dimensão das features (d)
     int num_worker_threads = 50;    // nº de threads
 
-    // Args: <num_users> <num_worker_threads> <feature_dim>
+    uint64_t seed = 42;             // mesma seed => mesmos dados
+
+    // Args: <num_users> <num_worker_threads> <feature_dim> <seed>
     if (argc >= 2) num_users = std::stoi(argv[1]);
     if (argc >= 3) num_worker_threads = std::stoi(argv[2]);
     if (argc >= 4) feature_dim = std::stoi(argv[3]);
+    if (argc >= 5) seed = std::stoull(argv[4]);
 
     std::cout << "Running with " << num_users << " users, "
               << num_worker_threads << " worker threads, feature_dim=" << feature_dim << "\n";
 
     // Dados
-    auto followers_matrix = generate_followers_matrix(num_users);       // n x n (0/1)
-    auto user_features    = generate_user_features(num_users, feature_dim); // n x d
+    auto followers_matrix = generate_followers_matrix(num_users, seed);       // n x n (0/1)
+    auto user_features    = generate_user_features(num_users, feature_dim,
+                                                   num_worker_threads, seed); // n x d
     std::vector<std::vector<double>> aggregated_features(
         num_users, std::vector<double>(feature_dim, 0.0));
 
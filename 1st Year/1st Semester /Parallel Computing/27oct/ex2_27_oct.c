@@ -1,5 +1,6 @@
 #include<omp.h>
 #include<stdio.h>
+#include "reduce.h"
 
 
 #define size 100000
@@ -11,12 +12,7 @@ int main() {
         b[i] = a[i] * a[i];
     }
     // compute dot product
-    double dot = 0;
-    #pragma omp parallel for
-    for(int i=0;i<size; i++) {
-    #pragma omp atomic
-        dot += a[i]*b[i];
-    }
+    double dot = reduce_dot(a, b, size, REDUCE_REPRO, omp_get_max_threads());
     printf("Dot is %18.16f\n",dot);
 }
     
\ No newline at end of file
@@ -21,5 +21,8 @@ perf stat ./fstprivate
 perf stat ./lstprivate
 perf stat ./reduce 
 
+# atomic vs reduction(+:) vs reduce.h (fast and reproducible)
+./reduce_bench 10000000 $OMP_NUM_THREADS
+
 
 echo "Finished"
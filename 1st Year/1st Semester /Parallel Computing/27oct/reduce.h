@@ -0,0 +1,155 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+
+/*
+ * Parallel reductions: dot, sum, norm2, min, max
+ *
+ * REDUCE_FAST:  each thread reduces its static block with a SIMD reduction,
+ *               the per-thread partials are combined with a pairwise tree.
+ *               No atomics and no shared cache line between threads, but the
+ *               rounding (and so the last bits) changes with the thread count.
+ * REDUCE_REPRO: the vector is cut into fixed REDUCE_CHUNK pieces, each piece is
+ *               summed with Kahan compensation in REDUCE_LANES fixed lanes, and
+ *               the piece partials are combined with a pairwise tree in index
+ *               order. Threads only decide WHO computes each piece, never the
+ *               order of the additions, so the result is bit-identical for any
+ *               number of threads.
+ * min/max are exact in any order, so they only have the fast version.
+ */
+
+enum { REDUCE_FAST, REDUCE_REPRO };
+
+#define REDUCE_CHUNK 4096
+#define REDUCE_LANES 8
+
+/* Stride of the per-thread partials: one per cache line, no false sharing */
+#define REDUCE_PAD 8
+
+/*
+ * Partials live on the stack, so a call does not allocate:
+ * fast mode uses at most REDUCE_MAX_THREADS threads (16 KiB of partials),
+ * repro mode keeps up to REDUCE_STACK_CHUNKS chunk partials on the stack
+ * (n <= 16M with the default sizes) and only mallocs beyond that.
+ */
+#define REDUCE_MAX_THREADS 256
+#define REDUCE_STACK_CHUNKS 4096
+
+/* Pairwise (tree) sum of n values: error grows with log(n) instead of n */
+static inline double pairwise_sum(const double *v, long n) {
+    if (n <= 2) return n == 0 ? 0.0 : (n == 1 ? v[0] : v[0] + v[1]);
+    long h = n / 2;
+    return pairwise_sum(v, h) + pairwise_sum(v + h, n - h);
+}
+
+/* Kahan sum of x[i]*y[i] (or x[i] if y == NULL) with REDUCE_LANES fixed lanes */
+static inline double kahan_chunk(const double *x, const double *y, long n) {
+    double s[REDUCE_LANES] = { 0 }, c[REDUCE_LANES] = { 0 };
+    long i = 0;
+
+    for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+        for (int l = 0; l < REDUCE_LANES; l++) {
+            double v = y ? x[i + l] * y[i + l] : x[i + l];
+            double t = v - c[l];
+            double u = s[l] + t;
+            c[l] = (u - s[l]) - t;
+            s[l] = u;
+        }
+    }
+    for (int l = 0; i < n; i++, l++) {
+        double v = y ? x[i] * y[i] : x[i];
+        double t = v - c[l];
+        double u = s[l] + t;
+        c[l] = (u - s[l]) - t;
+        s[l] = u;
+    }
+    return pairwise_sum(s, REDUCE_LANES);
+}
+
+static inline double reduce_repro(const double *x, const double *y, long n, int num_threads) {
+    long chunks = (n + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+    double stack_part[REDUCE_STACK_CHUNKS];
+    double *part = stack_part;
+
+    if (chunks > REDUCE_STACK_CHUNKS) {
+        part = (double *) malloc(chunks * sizeof(double));
+        if (part == NULL) {
+            fprintf(stderr, "reduce_repro: out of memory for %ld partials\n", chunks);
+            return NAN;
+        }
+    }
+
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (long k = 0; k < chunks; k++) {
+        long start = k * REDUCE_CHUNK;
+        long len = (start + REDUCE_CHUNK <= n) ? REDUCE_CHUNK : n - start;
+        part[k] = kahan_chunk(x + start, y ? y + start : NULL, len);
+    }
+
+    double r = pairwise_sum(part, chunks);
+    if (part != stack_part) free(part);
+    return r;
+}
+
+static inline double reduce_fast(const double *x, const double *y, long n, int num_threads) {
+    double part[REDUCE_MAX_THREADS * REDUCE_PAD] __attribute__((aligned(64)));
+    int used = 1;
+
+    if (num_threads > REDUCE_MAX_THREADS) num_threads = REDUCE_MAX_THREADS;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        long start = n * t / nt, end = n * (t + 1) / nt;
+        double s = 0.0;
+
+        if (y) {
+            #pragma omp simd reduction(+:s)
+            for (long i = start; i < end; i++) s += x[i] * y[i];
+        } else {
+            #pragma omp simd reduction(+:s)
+            for (long i = start; i < end; i++) s += x[i];
+        }
+        part[t * REDUCE_PAD] = s;
+        if (t == 0) used = nt;
+    }
+
+    /* tree combine of the per-thread partials (compacted in place first) */
+    for (int t = 1; t < used; t++) part[t] = part[t * REDUCE_PAD];
+    return pairwise_sum(part, used);
+}
+
+static inline double reduce_dot(const double *x, const double *y, long n, int mode, int num_threads) {
+    return mode == REDUCE_REPRO ? reduce_repro(x, y, n, num_threads)
+                                : reduce_fast(x, y, n, num_threads);
+}
+
+static inline double reduce_sum(const double *x, long n, int mode, int num_threads) {
+    return mode == REDUCE_REPRO ? reduce_repro(x, NULL, n, num_threads)
+                                : reduce_fast(x, NULL, n, num_threads);
+}
+
+static inline double reduce_norm2(const double *x, long n, int mode, int num_threads) {
+    return sqrt(reduce_dot(x, x, n, mode, num_threads));
+}
+
+static inline double reduce_min(const double *x, long n, int num_threads) {
+    double m = DBL_MAX;
+    #pragma omp parallel for simd reduction(min:m) num_threads(num_threads)
+    for (long i = 0; i < n; i++) m = x[i] < m ? x[i] : m;
+    return m;
+}
+
+static inline double reduce_max(const double *x, long n, int num_threads) {
+    double m = -DBL_MAX;
+    #pragma omp parallel for simd reduction(max:m) num_threads(num_threads)
+    for (long i = 0; i < n; i++) m = x[i] > m ? x[i] : m;
+    return m;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include<omp.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include "reduce.h"
+
+// Dot product benchmark: atomic (ex2) vs reduction(+:) vs reduce.h
+// Usage: ./reduce_bench [n] [threads] [reps]
+
+long n = 10000000;
+int nt = 2;
+int reps = 5;
+double *a, *b;
+
+double dot_atomic(void) {
+    double dot = 0;
+    #pragma omp parallel for num_threads(nt)
+    for(long i=0;i<n; i++) {
+    #pragma omp atomic
+        dot += a[i]*b[i];
+    }
+    return dot;
+}
+
+double dot_omp_reduction(void) {
+    double dot = 0;
+    #pragma omp parallel for reduction(+:dot) num_threads(nt)
+    for(long i=0;i<n; i++) dot += a[i]*b[i];
+    return dot;
+}
+
+double dot_fast(void)  { return reduce_dot(a, b, n, REDUCE_FAST, nt); }
+double dot_repro(void) { return reduce_dot(a, b, n, REDUCE_REPRO, nt); }
+
+// best time of reps runs; the atomic version is slow, so it runs once
+void bench(const char *name, double (*f)(void), int runs, long double ref) {
+    double best = 1e30, r = 0;
+    for(int k=0;k<runs;k++) {
+        double t0 = omp_get_wtime();
+        r = f();
+        double t1 = omp_get_wtime();
+        if(t1-t0 < best) best = t1-t0;
+    }
+    double gbs = 2.0 * n * sizeof(double) * 1e-9 / best;
+    printf("%-18s %10.6f s %8.2f GB/s  dot=%.17g  err=%.3Le\n",
+           name, best, gbs, r, (long double) r - ref);
+}
+
+int main(int argc, char **argv) {
+    if(argc >= 2) n = atol(argv[1]);
+    if(argc >= 3) nt = atoi(argv[2]);
+    if(argc >= 4) reps = atoi(argv[3]);
+    if(n <= 0 || nt <= 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [n] [threads] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    a = (double *) malloc(n * sizeof(double));
+    b = (double *) malloc(n * sizeof(double));
+    // same kind of data as ex2: values spread over many magnitudes
+    for(long i=0;i<n; i++) {
+        a[i] = 1.0/((double) (n-i));
+        b[i] = (i % 2 ? -1.0 : 1.0) * a[i] * 1e3 + 1.0;
+    }
+
+    long double ref = 0;
+    for(long i=0;i<n; i++) ref += (long double) a[i] * b[i];
+
+    printf("n=%ld threads=%d\n", n, nt);
+    bench("omp atomic", dot_atomic, 1, ref);
+    bench("reduction(+:)", dot_omp_reduction, reps, ref);
+    bench("reduce.h fast", dot_fast, reps, ref);
+    bench("reduce.h repro", dot_repro, reps, ref);
+
+    // the reproducible mode must give the same bits for any thread count
+    int save = nt, same = 1;
+    double first = 0;
+    for(nt=1; nt<=2*save; nt++) {
+        double r = dot_repro();
+        if(nt == 1) first = r;
+        else if(memcmp(&r, &first, sizeof(double)) != 0) {
+            printf("repro differs with %d threads: %.17g vs %.17g\n", nt, r, first);
+            same = 0;
+        }
+    }
+    nt = save;
+    printf("repro bit-identical for 1..%d threads: %s\n", 2*save, same ? "yes" : "NO");
+
+    printf("sum=%.17g norm2=%.17g min=%g max=%g\n",
+           reduce_sum(b, n, REDUCE_REPRO, nt), reduce_norm2(b, n, REDUCE_REPRO, nt),
+           reduce_min(b, n, nt), reduce_max(b, n, nt));
+
+    free(a);
+    free(b);
+    return !same;
+}
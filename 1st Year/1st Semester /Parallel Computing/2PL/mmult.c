@@ -1,5 +1,6 @@
 #include<stdio.h>
 #include<stdlib.h>
+#include "../counterRng.h"
 
 #ifndef size
 #define size 512
@@ -13,12 +14,18 @@ void alloc() {
     C = (double *) malloc(size*size*sizeof(double));
 }
 
+// Gerador por contador (counterRng.h): o valor (i,j) não depende da ordem
+// de geração, por isso os dados são iguais aos das outras versões
 void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
     for(int i=0; i<size; i++) {
         for(int j=0; j<size; j++) {
-            A[i*size+j] = rand();
-            B[i*size+j] = rand();
-            C[i*size+j] = 0;
+            const uint64_t idx = (uint64_t) i*size+j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0;
         }
     }
 }
@@ -1,5 +1,6 @@
 #include<stdio.h>
 #include<stdlib.h>
+#include "../counterRng.h"
 #include<thread>
 
 #ifndef N
@@ -18,12 +19,18 @@ void alloc() {
     C = (double *) malloc(N*N*sizeof(double));
 }
 
+// Gerador por contador (counterRng.h): o valor (i,j) não depende da ordem
+// de geração, por isso os dados são iguais aos das outras versões
 void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
     for(int i=0; i<N; i++) {
         for(int j=0; j<N; j++) {
-            A[i*N+j] = rand();
-            B[i*N+j] = rand();
-            C[i*N+j] = 0;
+            const uint64_t idx = (uint64_t) i*N+j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0;
         }
     }
 }
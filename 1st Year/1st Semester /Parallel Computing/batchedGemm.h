@@ -0,0 +1,166 @@
+#ifndef BATCHED_GEMM_H
+#define BATCHED_GEMM_H
+
+#include <utility> // para std::integer_sequence
+
+// ------------------------------------------------------------
+// GEMM em lote para matrizes pequenas (4x4 .. 32x32)
+// Para milhões de produtos minúsculos não compensa paralelizar cada produto:
+// vetorizamos ATRAVÉS do lote e paralelizamos entre grupos do lote.
+//
+// Layout intercalado (AoSoA): o lote é dividido em grupos de BATCH_LANES
+// matrizes; dentro de um grupo, o elemento e das BATCH_LANES matrizes fica
+// contíguo. Para o grupo g e a matriz l do grupo:
+//   X[g*rows*cols*BATCH_LANES + e*BATCH_LANES + l]  com e = r*cols + c
+// Assim cada operação escalar do kernel é uma operação vetorial sobre lanes.
+// ------------------------------------------------------------
+
+// 8 doubles = um registo AVX-512 (ou dois AVX2 / quatro NEON)
+#ifndef BATCH_LANES
+#define BATCH_LANES 8
+#endif
+
+// Número de grupos necessários para batch matrizes (o último é completado)
+inline int batchGroups(int batch) {
+    return (batch + BATCH_LANES - 1) / BATCH_LANES;
+}
+
+// Número de doubles de um lote intercalado de matrizes rows x cols
+inline long interleavedSize(int rows, int cols, int batch) {
+    return (long) batchGroups(batch) * rows * cols * BATCH_LANES;
+}
+
+// src: batch matrizes row-major seguidas; dst: layout intercalado
+// As lanes de preenchimento do último grupo ficam a zero.
+inline void interleave(const double *src, double *dst, int rows, int cols, int batch) {
+    const int elems = rows * cols;
+    for (int g = 0; g < batchGroups(batch); g++) {
+        double *d = dst + (long) g * elems * BATCH_LANES;
+        for (int e = 0; e < elems; e++) {
+            for (int l = 0; l < BATCH_LANES; l++) {
+                const int b = g * BATCH_LANES + l;
+                d[e * BATCH_LANES + l] = (b < batch) ? src[(long) b * elems + e] : 0.0;
+            }
+        }
+    }
+}
+
+inline void deinterleave(const double *src, double *dst, int rows, int cols, int batch) {
+    const int elems = rows * cols;
+    for (int b = 0; b < batch; b++) {
+        const double *s = src + (long) (b / BATCH_LANES) * elems * BATCH_LANES + b % BATCH_LANES;
+        for (int e = 0; e < elems; e++) {
+            dst[(long) b * elems + e] = s[e * BATCH_LANES];
+        }
+    }
+}
+
+// Desenrola f(0), f(1), ..., f(Count-1) em tempo de compilação
+template <typename F, int... Is>
+inline void unrollImpl(F &&f, std::integer_sequence<int, Is...>) {
+    (f(Is), ...);
+}
+
+template <int Count, typename F>
+inline void unroll(F &&f) {
+    unrollImpl(f, std::make_integer_sequence<int, Count>{});
+}
+
+// ------------------------------------------------------------
+// Kernel de um grupo com tamanhos em tempo de compilação:
+// C (M x N) += A (M x K) * B (K x N), BATCH_LANES produtos de uma vez.
+// O ciclo em k é totalmente desenrolado; i e j têm limites constantes,
+// e o ciclo em lanes é o que o compilador vetoriza.
+// ------------------------------------------------------------
+template <int M, int N, int K>
+inline void gemmGroup(const double *__restrict A, const double *__restrict B, double *__restrict C) {
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+            double acc[BATCH_LANES];
+            double *c = C + (i * N + j) * BATCH_LANES;
+
+            #pragma omp simd
+            for (int l = 0; l < BATCH_LANES; ++l) acc[l] = c[l];
+
+            unroll<K>([&](int k) {
+                const double *a = A + (i * K + k) * BATCH_LANES;
+                const double *b = B + (k * N + j) * BATCH_LANES;
+                #pragma omp simd
+                for (int l = 0; l < BATCH_LANES; ++l) acc[l] += a[l] * b[l];
+            });
+
+            #pragma omp simd
+            for (int l = 0; l < BATCH_LANES; ++l) c[l] = acc[l];
+        }
+    }
+}
+
+// Versão com tamanhos em tempo de execução (fallback para tamanhos sem kernel)
+inline void gemmGroupRuntime(int M, int N, int K,
+                             const double *__restrict A, const double *__restrict B, double *__restrict C) {
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+            double acc[BATCH_LANES];
+            double *c = C + (i * N + j) * BATCH_LANES;
+
+            #pragma omp simd
+            for (int l = 0; l < BATCH_LANES; ++l) acc[l] = c[l];
+
+            for (int k = 0; k < K; ++k) {
+                const double *a = A + (i * K + k) * BATCH_LANES;
+                const double *b = B + (k * N + j) * BATCH_LANES;
+                #pragma omp simd
+                for (int l = 0; l < BATCH_LANES; ++l) acc[l] += a[l] * b[l];
+            }
+
+            #pragma omp simd
+            for (int l = 0; l < BATCH_LANES; ++l) c[l] = acc[l];
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// API em lote: A, B e C em layout intercalado, batch produtos C += A * B.
+// Os grupos são independentes, por isso são divididos pelas threads.
+// ------------------------------------------------------------
+template <int M, int N, int K>
+void gemmBatched(const double *A, const double *B, double *C, int batch, int numThreads) {
+    const int groups = batchGroups(batch);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int g = 0; g < groups; ++g) {
+        gemmGroup<M, N, K>(A + (long) g * M * K * BATCH_LANES,
+                           B + (long) g * K * N * BATCH_LANES,
+                           C + (long) g * M * N * BATCH_LANES);
+    }
+}
+
+inline void gemmBatchedRuntime(int M, int N, int K, const double *A, const double *B, double *C,
+                               int batch, int numThreads) {
+    const int groups = batchGroups(batch);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int g = 0; g < groups; ++g) {
+        gemmGroupRuntime(M, N, K,
+                         A + (long) g * M * K * BATCH_LANES,
+                         B + (long) g * K * N * BATCH_LANES,
+                         C + (long) g * M * N * BATCH_LANES);
+    }
+}
+
+// Escolhe o kernel especializado quando existe (quadrados 4, 8, 16, 32),
+// senão usa a versão com tamanhos em tempo de execução
+inline void gemmBatched(int M, int N, int K, const double *A, const double *B, double *C,
+                        int batch, int numThreads) {
+    if (M == N && N == K) {
+        switch (M) {
+            case 4:  gemmBatched<4, 4, 4>(A, B, C, batch, numThreads);     return;
+            case 8:  gemmBatched<8, 8, 8>(A, B, C, batch, numThreads);     return;
+            case 16: gemmBatched<16, 16, 16>(A, B, C, batch, numThreads);  return;
+            case 32: gemmBatched<32, 32, 32>(A, B, C, batch, numThreads);  return;
+        }
+    }
+    gemmBatchedRuntime(M, N, K, A, B, C, batch, numThreads);
+}
+
+#endif // BATCHED_GEMM_H
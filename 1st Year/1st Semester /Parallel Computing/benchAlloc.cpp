@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <sys/resource.h>
+
+#include "matrixAlloc.h"
+#include "perfCounters.h"
+
+// ------------------------------------------------------------
+// Benchmark do alocador (matrixAlloc.h) contra malloc + init serial
+// Para cada configuração mede:
+//  - page faults durante o first touch (páginas de 2 MiB => ~512x menos)
+//  - largura de banda de uma triad paralela C = A + s*B (GB/s)
+//  - percurso por colunas de A (uma página nova por acesso com 4 KiB):
+//    ns por acesso e dTLB misses (perfCounters.h, se o hardware deixar)
+// Numa máquina NUMA, a triad é onde o first touch paralelo se nota.
+//
+// Uso: ./benchAlloc [size] [threads] [reps]
+// ------------------------------------------------------------
+
+int sizeMatrix = 4096;
+int numThreads = 2;
+int reps = 5;
+
+const char *pageNames[] = { "4K", "THP", "hugetlb" };
+
+long minorFaults() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt;
+}
+
+// Triad paralela com a mesma partição por linhas do first touch
+double triad(double *A, double *B, double *C) {
+    const int N = sizeMatrix;
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        double t0 = omp_get_wtime();
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int i = 0; i < N; i++) {
+            const double *a = A + (size_t) i * N;
+            const double *b = B + (size_t) i * N;
+            double *c = C + (size_t) i * N;
+            #pragma omp simd
+            for (int j = 0; j < N; j++) c[j] = a[j] + 3.0 * b[j];
+        }
+        double t1 = omp_get_wtime();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return 3.0 * N * (double) N * sizeof(double) * 1e-9 / best;
+}
+
+// Percorre A por colunas: acessos com stride N*8 bytes
+double columnWalk(double *A, long long *tlbMisses) {
+    const int N = sizeMatrix;
+    volatile double sink = 0.0;
+
+    perfStart();
+    double sum = 0.0;
+    for (int j = 0; j < N; j += 8)
+        for (int i = 0; i < N; i++)
+            sum += A[(size_t) i * N + j];
+    PerfSample s = perfStop();
+    sink = sum;
+    (void) sink;
+
+    *tlbMisses = s.valid[PC_DTLB_MISSES] ? s.count[PC_DTLB_MISSES] : -1;
+    return s.seconds * 1e9 / ((double) N * (N / 8));
+}
+
+// mode < 0: malloc + init serial (o alloc() original); senão allocMatrix(mode)
+void run(const char *name, int mode) {
+    const size_t elems = (size_t) sizeMatrix * sizeMatrix;
+    double *A, *B, *C;
+    long faults = minorFaults();
+
+    if (mode < 0) {
+        A = (double *) malloc(elems * sizeof(double));
+        B = (double *) malloc(elems * sizeof(double));
+        C = (double *) malloc(elems * sizeof(double));
+        memset(A, 0, elems * sizeof(double));
+        memset(B, 0, elems * sizeof(double));
+        memset(C, 0, elems * sizeof(double));
+    } else {
+        A = allocMatrix(elems, mode);
+        B = allocMatrix(elems, mode);
+        C = allocMatrix(elems, mode);
+        if (!A || !B || !C) { fprintf(stderr, "%s: out of memory\n", name); exit(1); }
+        firstTouch(A, sizeMatrix, sizeMatrix, numThreads);
+        firstTouch(B, sizeMatrix, sizeMatrix, numThreads);
+        firstTouch(C, sizeMatrix, sizeMatrix, numThreads);
+    }
+    faults = minorFaults() - faults;
+
+    for (size_t i = 0; i < elems; i++) A[i] = (double) (i & 1023);
+
+    double gbs = triad(A, B, C);
+    long long misses;
+    double ns = columnWalk(A, &misses);
+
+    const char *pages = (mode < 0) ? "4K" : pageNames[allocHugePages(A)];
+    printf("%-28s %-8s %10ld %10.2f %10.2f ", name, pages, faults, gbs, ns);
+    if (misses >= 0) printf("%14lld\n", misses);
+    else             printf("%14s\n", "n/a");
+
+    if (mode < 0) {
+        free(A); free(B); free(C);
+    } else {
+        freeMatrix(A); freeMatrix(B); freeMatrix(C);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) sizeMatrix = atoi(argv[1]);
+    if (argc >= 3) numThreads = atoi(argv[2]);
+    if (argc >= 4) reps       = atoi(argv[3]);
+    if (sizeMatrix <= 0 || numThreads <= 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [size] [threads] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    perfInit(numThreads);
+
+    printf("size=%d threads=%d (%.1f MiB per matrix)\n", sizeMatrix, numThreads,
+           sizeMatrix * (double) sizeMatrix * sizeof(double) / (1024.0 * 1024.0));
+    printf("%-28s %-8s %10s %10s %10s %14s\n",
+           "allocator", "pages", "faults", "triad GB/s", "col ns", "dTLB misses");
+
+    run("malloc + serial init", -1);
+    run("aligned + first touch", HUGE_NONE);
+    run("THP + first touch", HUGE_TRANSPARENT);
+    run("hugetlb + first touch", HUGE_EXPLICIT);
+
+    perfClose();
+    return 0;
+}
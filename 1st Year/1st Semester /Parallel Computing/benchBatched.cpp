@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+#include "batchedGemm.h"
+#include "counterRng.h"
+
+// ------------------------------------------------------------
+// Benchmark do GEMM em lote para matrizes pequenas
+// Para cada tamanho compara:
+//  - naive:    um produto de cada vez, layout normal (row-major seguidas)
+//  - runtime:  layout intercalado, tamanhos em tempo de execução
+//  - template: layout intercalado, kernel especializado (M, N, K)
+// O total de elementos é mais ou menos constante, por isso o lote diminui
+// à medida que as matrizes crescem.
+//
+// Uso: ./benchBatched [elements] [threads] [reps]
+// ------------------------------------------------------------
+
+long totalElements = 1L << 22;
+int numThreads = 2;
+int reps = 5;
+
+// Produto a produto, sem intercalar (o que cada programa faria sozinho)
+void gemmNaive(int M, int N, int K, const double *A, const double *B, double *C, int batch) {
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int b = 0; b < batch; b++) {
+        const double *a = A + (long) b * M * K;
+        const double *bb = B + (long) b * K * N;
+        double *c = C + (long) b * M * N;
+        for (int i = 0; i < M; i++)
+            for (int k = 0; k < K; k++)
+                for (int j = 0; j < N; j++)
+                    c[i * N + j] += a[i * K + k] * bb[k * N + j];
+    }
+}
+
+int maxError(const double *x, const double *y, long n) {
+    for (long i = 0; i < n; i++)
+        if (fabs(x[i] - y[i]) > 1e-12 * (1.0 + fabs(x[i]))) return 1;
+    return 0;
+}
+
+int run(int M, int N, int K) {
+    int batch = (int) (totalElements / (M * N));
+    if (batch < 1) batch = 1;
+
+    long sa = (long) batch * M * K, sb = (long) batch * K * N, sc = (long) batch * M * N;
+    double *A  = (double *) malloc(sa * sizeof(double));
+    double *B  = (double *) malloc(sb * sizeof(double));
+    double *C  = (double *) calloc(sc, sizeof(double));
+    double *Ci = (double *) malloc(sc * sizeof(double));
+    double *Ai = (double *) malloc(interleavedSize(M, K, batch) * sizeof(double));
+    double *Bi = (double *) malloc(interleavedSize(K, N, batch) * sizeof(double));
+    double *Cr = (double *) calloc(interleavedSize(M, N, batch), sizeof(double));
+    double *Ct = (double *) calloc(interleavedSize(M, N, batch), sizeof(double));
+
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long i = 0; i < sa; i++) A[i] = rngUniform(keyA, i);
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long i = 0; i < sb; i++) B[i] = rngUniform(keyB, i);
+    interleave(A, Ai, M, K, batch);
+    interleave(B, Bi, K, N, batch);
+
+    // Cada repetição acumula em C, por isso os três acabam com reps * A*B
+    double tNaive = 1e30, tRuntime = 1e30, tTemplate = 1e30;
+    for (int r = 0; r < reps; r++) {
+        double t0 = omp_get_wtime();
+        gemmNaive(M, N, K, A, B, C, batch);
+        double t1 = omp_get_wtime();
+        gemmBatchedRuntime(M, N, K, Ai, Bi, Cr, batch, numThreads);
+        double t2 = omp_get_wtime();
+        gemmBatched(M, N, K, Ai, Bi, Ct, batch, numThreads);
+        double t3 = omp_get_wtime();
+        if (t1 - t0 < tNaive)    tNaive = t1 - t0;
+        if (t2 - t1 < tRuntime)  tRuntime = t2 - t1;
+        if (t3 - t2 < tTemplate) tTemplate = t3 - t2;
+    }
+
+    deinterleave(Cr, Ci, M, N, batch);
+    int bad = maxError(C, Ci, sc);
+    deinterleave(Ct, Ci, M, N, batch);
+    bad |= maxError(C, Ci, sc);
+
+    double gflop = 2.0 * M * N * K * (double) batch * 1e-9;
+    printf("%2dx%2dx%2d batch=%8d  naive %7.2f  runtime %7.2f  template %7.2f GFLOP/s%s\n",
+           M, N, K, batch, gflop / tNaive, gflop / tRuntime, gflop / tTemplate,
+           bad ? "  MISMATCH" : "");
+
+    free(A); free(B); free(C); free(Ci);
+    free(Ai); free(Bi); free(Cr); free(Ct);
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) totalElements = atol(argv[1]);
+    if (argc >= 3) numThreads    = atoi(argv[2]);
+    if (argc >= 4) reps          = atoi(argv[3]);
+    if (totalElements <= 0 || numThreads <= 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [elements] [threads] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    printf("lanes=%d threads=%d\n", BATCH_LANES, numThreads);
+    int bad = 0;
+    bad |= run(4, 4, 4);
+    bad |= run(8, 8, 8);
+    bad |= run(16, 16, 16);
+    bad |= run(32, 32, 32);
+    bad |= run(6, 10, 3); // sem kernel especializado: usa o fallback
+
+    return bad;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <chrono>
+
+#include "counterRng.h"
+#include "gemm.h"
+#include "workSteal.h"
+
+// ------------------------------------------------------------
+// Benchmark: work stealing (matrixMultV4) vs OpenMP schedule(static)
+// (matrixMultV3) com desequilíbrio induzido.
+// A thread 0 faz uma espera ativa de delayUs microssegundos após cada tile,
+// simulando um core partilhado/oversubscribed. Com schedule(static) o tempo
+// total fica preso à thread lenta; com work stealing as outras compensam.
+//
+// Uso: ./benchImbalance [size] [threads] [delayUs] [reps]
+// ------------------------------------------------------------
+
+int sizeMatrix = 512;
+int numThreads = 2;
+int delayUs = 200;
+int reps = 3;
+
+double *A, *B_T, *C;
+
+void alloc() {
+    A   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
+    B_T = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
+    C   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
+}
+
+// Mesmos dados que as outras versões (counterRng.h), gerados em paralelo
+void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < sizeMatrix; i++) {
+        for (int j = 0; j < sizeMatrix; j++) {
+            const uint64_t idx = (uint64_t) i * sizeMatrix + j;
+            A[idx]   = rngUniform(keyA, idx);
+            B_T[idx] = rngUniform(keyB, idx);
+        }
+    }
+}
+
+// Espera ativa (não usa sleep para a thread continuar a ocupar o core)
+void stall(int threadID) {
+    if (threadID != 0 || delayUs <= 0) return;
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(delayUs);
+    while (std::chrono::steady_clock::now() < until) { }
+}
+
+// O mesmo ciclo que o matrixMultBlocked() da V3: índice linear dos tiles
+// com schedule(static), mais o atraso da thread 0
+void multStatic() {
+    const int N = sizeMatrix;
+    const int tiles = numTiles(N, N);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int t = 0; t < tiles; t++) {
+        multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
+        stall(omp_get_thread_num());
+    }
+}
+
+// Os workers só são fixados se a pool OpenMP também for (bindThreads()),
+// para as duas versões correrem nas mesmas condições
+void multStealing() {
+    const int N = sizeMatrix;
+    runWorkStealing(numTiles(N, N), numThreads, [N](int t, int id) {
+        multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
+        stall(id);
+    }, bindThreads());
+}
+
+// Corre reps vezes e devolve o melhor tempo (segundos)
+double timeIt(void (*mult)(), double *checksum) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        memset(C, 0, sizeMatrix * sizeMatrix * sizeof(double));
+        double t0 = omp_get_wtime();
+        mult();
+        double t1 = omp_get_wtime();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < sizeMatrix * sizeMatrix; i++) sum += C[i];
+    *checksum = sum;
+    return best;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) sizeMatrix = atoi(argv[1]);
+    if (argc >= 3) numThreads = atoi(argv[2]);
+    if (argc >= 4) delayUs    = atoi(argv[3]);
+    if (argc >= 5) reps       = atoi(argv[4]);
+    if (sizeMatrix <= 0 || numThreads <= 0 || delayUs < 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [size] [threads] [delayUs] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    alloc();
+    init();
+
+    double sumStatic, sumSteal;
+    double tStatic = timeIt(multStatic, &sumStatic);
+    double tSteal  = timeIt(multStealing, &sumSteal);
+
+    if (fabs(sumStatic - sumSteal) > 1e-9 * fabs(sumStatic)) {
+        fprintf(stderr, "Results differ: %f vs %f\n", sumStatic, sumSteal);
+        return 1;
+    }
+
+    double gflop = 2.0 * sizeMatrix * (double) sizeMatrix * sizeMatrix * 1e-9;
+    printf("size=%d threads=%d tiles=%d delay=%dus/tile (thread 0)\n",
+           sizeMatrix, numThreads, numTiles(sizeMatrix, sizeMatrix), delayUs);
+    printf("%-22s %10.4f s %8.2f GFLOP/s\n", "omp schedule(static)", tStatic, gflop / tStatic);
+    printf("%-22s %10.4f s %8.2f GFLOP/s\n", "work stealing", tSteal, gflop / tSteal);
+    printf("speedup: %.2fx\n", tStatic / tSteal);
+
+    free(A);
+    free(B_T);
+    free(C);
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#include "counterRng.h"
+#include "transpose.h"
+
+// ------------------------------------------------------------
+// Benchmark de largura de banda: transposição e packing vs memcpy
+// GB/s = (bytes lidos + bytes escritos) / tempo; o memcpy do mesmo tamanho
+// é o limite prático que qualquer transposição pode atingir.
+//
+// Uso: ./benchTranspose [size] [threads] [reps]
+// ------------------------------------------------------------
+
+#define MR 4
+#define NR 8
+
+int sizeMatrix = 4096;
+int numThreads = 2;
+int reps = 5;
+
+double *B, *B_T, *P;
+
+void alloc() {
+    B   = (double *) malloc(sizeMatrix * (long) sizeMatrix * sizeof(double));
+    B_T = (double *) malloc(sizeMatrix * (long) sizeMatrix * sizeof(double));
+    P   = (double *) malloc(packedSize(sizeMatrix, sizeMatrix, NR) * sizeof(double));
+}
+
+void init() {
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long i = 0; i < (long) sizeMatrix * sizeMatrix; i++) {
+        B[i] = rngUniform(keyB, i);
+    }
+    // Toca no destino para não medir page faults na primeira repetição
+    memset(B_T, 0, sizeMatrix * (long) sizeMatrix * sizeof(double));
+    memset(P, 0, packedSize(sizeMatrix, sizeMatrix, NR) * sizeof(double));
+}
+
+// O transposeB() original (serial, escritas com stride N)
+void transposeNaive() {
+    for (int i = 0; i < sizeMatrix; i++) {
+        for (int j = 0; j < sizeMatrix; j++) {
+            B_T[(long) j * sizeMatrix + i] = B[(long) i * sizeMatrix + j];
+        }
+    }
+}
+
+void transposeObl()  { transpose(B, sizeMatrix, B_T, sizeMatrix, sizeMatrix, sizeMatrix, numThreads); }
+void transposeObl1() { transpose(B, sizeMatrix, B_T, sizeMatrix, sizeMatrix, sizeMatrix, 1); }
+void packPanelsA()   { packA(B, sizeMatrix, P, sizeMatrix, sizeMatrix, MR, numThreads); }
+void packPanelsB()   { packB(B, sizeMatrix, P, sizeMatrix, sizeMatrix, NR, numThreads); }
+void copy()          { memcpy(B_T, B, sizeMatrix * (long) sizeMatrix * sizeof(double)); }
+
+// Melhor tempo em reps repetições
+double timeIt(void (*fn)()) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        double t0 = omp_get_wtime();
+        fn();
+        double t1 = omp_get_wtime();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+int check() {
+    for (int i = 0; i < sizeMatrix; i++)
+        for (int j = 0; j < sizeMatrix; j++)
+            if (B_T[(long) j * sizeMatrix + i] != B[(long) i * sizeMatrix + j]) return 0;
+    return 1;
+}
+
+// Painéis de A (M x K de B, lda = sizeMatrix): dst[p*MR*K + k*MR + r] = A[p*MR + r][k],
+// com zeros nas linhas que passam de M
+int checkPackA(int M, int K) {
+    for (int p = 0; p < (M + MR - 1) / MR; p++)
+        for (int k = 0; k < K; k++)
+            for (int r = 0; r < MR; r++) {
+                const int i = p * MR + r;
+                const double expected = i < M ? B[(long) i * sizeMatrix + k] : 0.0;
+                if (P[(long) p * MR * K + (long) k * MR + r] != expected) return 0;
+            }
+    return 1;
+}
+
+// Painéis de B (K x N de B, ldb = sizeMatrix): dst[q*NR*K + k*NR + c] = B[k][q*NR + c],
+// com zeros nas colunas que passam de N
+int checkPackB(int K, int N) {
+    for (int q = 0; q < (N + NR - 1) / NR; q++)
+        for (int k = 0; k < K; k++)
+            for (int c = 0; c < NR; c++) {
+                const int j = q * NR + c;
+                const double expected = j < N ? B[(long) k * sizeMatrix + j] : 0.0;
+                if (P[(long) q * NR * K + (long) k * NR + c] != expected) return 0;
+            }
+    return 1;
+}
+
+// Tamanho irregular (não múltiplo de MR/NR) para testar o padding; P é
+// enchido com NaN antes, para apanhar posições que o packing não escreve
+int checkPackRagged() {
+    const int M = sizeMatrix > 1 ? sizeMatrix - 1 : 1;
+    const int K = sizeMatrix > 3 ? sizeMatrix - 3 : 1;
+    const int N = sizeMatrix > 5 ? sizeMatrix - 5 : 1;
+    const long bytes = packedSize(sizeMatrix, sizeMatrix, NR) * sizeof(double);
+
+    memset(P, 0xff, bytes);
+    packA(B, sizeMatrix, P, M, K, MR, numThreads);
+    if (!checkPackA(M, K)) return 0;
+
+    memset(P, 0xff, bytes);
+    packB(B, sizeMatrix, P, K, N, NR, numThreads);
+    return checkPackB(K, N);
+}
+
+void report(const char *name, double t) {
+    double gb = 2.0 * sizeMatrix * (double) sizeMatrix * sizeof(double) * 1e-9;
+    printf("%-26s %10.4f s %8.2f GB/s\n", name, t, gb / t);
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) sizeMatrix = atoi(argv[1]);
+    if (argc >= 3) numThreads = atoi(argv[2]);
+    if (argc >= 4) reps       = atoi(argv[3]);
+    if (sizeMatrix <= 0 || numThreads <= 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [size] [threads] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    alloc();
+    init();
+
+    printf("size=%d threads=%d (%.1f MiB per matrix)\n", sizeMatrix, numThreads,
+           sizeMatrix * (double) sizeMatrix * sizeof(double) / (1024.0 * 1024.0));
+
+    report("memcpy", timeIt(copy));
+
+    report("transpose naive (serial)", timeIt(transposeNaive));
+    if (!check()) { fprintf(stderr, "naive transpose is wrong\n"); return 1; }
+
+    memset(B_T, 0, sizeMatrix * (long) sizeMatrix * sizeof(double));
+    report("transpose oblivious (1T)", timeIt(transposeObl1));
+    if (!check()) { fprintf(stderr, "oblivious transpose is wrong\n"); return 1; }
+
+    memset(B_T, 0, sizeMatrix * (long) sizeMatrix * sizeof(double));
+    report("transpose oblivious", timeIt(transposeObl));
+    if (!check()) { fprintf(stderr, "parallel transpose is wrong\n"); return 1; }
+
+    report("packA (MR=4)", timeIt(packPanelsA));
+    if (!checkPackA(sizeMatrix, sizeMatrix)) { fprintf(stderr, "packA is wrong\n"); return 1; }
+
+    report("packB (NR=8)", timeIt(packPanelsB));
+    if (!checkPackB(sizeMatrix, sizeMatrix)) { fprintf(stderr, "packB is wrong\n"); return 1; }
+
+    if (!checkPackRagged()) { fprintf(stderr, "packing of ragged sizes is wrong\n"); return 1; }
+
+    free(B);
+    free(B_T);
+    free(P);
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <stdint.h>
+
+// ------------------------------------------------------------
+// Gerador aleatório baseado em contador (estilo SplitMix64)
+// Em vez de um estado partilhado (rand(), std::mt19937), o valor número
+// index de uma stream é calculado diretamente:
+//   uint64_t key = rngKey(seed, stream);  // uma vez por matriz/stream
+//   double x = rngUniform(key, index);    // ex: index = i*N + j
+// Qualquer thread pode gerar o elemento (i,j) sozinha, sem sincronização,
+// e os dados são iguais para qualquer número de threads e qualquer libc.
+// Compatível com C e C++ (só usa stdint.h).
+//
+// O lab 1 de Arquiteturas Avançadas tem o mesmo gerador em src/counter_rng.h
+// (rng_mix, rng_key, ...). Os dois têm de dar os mesmos bits; valores de
+// referência, verificados lá com static_assert:
+//   rngAt(rngKey(42, 0), 0)     == 0xCA685846B557F0FC
+//   rngAt(rngKey(123, 1), 1000) == 0x26A102A3AA5DBEDF
+// ------------------------------------------------------------
+
+#define RNG_GOLDEN 0x9E3779B97F4A7C15ULL
+
+// Semente por omissão dos programas (pode ser mudada com -DRNG_SEED=...)
+#ifndef RNG_SEED
+#define RNG_SEED 42
+#endif
+
+// Finalizador do SplitMix64: mistura bem todos os bits de x
+static inline uint64_t rngMix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Chave de uma stream: streams diferentes (ex: A e B) ficam independentes
+static inline uint64_t rngKey(uint64_t seed, uint64_t stream) {
+    return rngMix(seed ^ rngMix(stream * RNG_GOLDEN + RNG_GOLDEN));
+}
+
+// Valor número index da stream; igual ao passo index+1 do SplitMix64
+// começado no estado key
+static inline uint64_t rngAt(uint64_t key, uint64_t index) {
+    return rngMix(key + (index + 1) * RNG_GOLDEN);
+}
+
+// Double uniforme em [0, 1) a partir dos 53 bits mais altos
+static inline double rngUniform(uint64_t key, uint64_t index) {
+    return (double) (rngAt(key, index) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif // COUNTER_RNG_H
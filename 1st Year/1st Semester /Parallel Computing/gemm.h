@@ -0,0 +1,154 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <algorithm> // para std::min
+#include <math.h>
+
+#ifndef TILE_SIZE
+#define TILE_SIZE 32
+#endif
+
+// ------------------------------------------------------------
+// Kernel por blocos partilhado pelas várias versões (V3, V4, ...)
+// Convenção: C (M x N) += A (M x K) * B, com B já transposta em B_T (N x K)
+// lda/ldb/ldc são os strides das linhas, para poder trabalhar sobre
+// sub-matrizes (painéis, tiles de ficheiros, blocos locais, ...)
+// ------------------------------------------------------------
+
+// Calcula um único tile de saída C[i0:i1, j0:j1], percorrendo K por blocos.
+// Tiles distintos escrevem regiões distintas de C, por isso podem ser
+// distribuídos entre threads sem data races.
+inline void multTile(const double *A, int lda, const double *B_T, int ldb,
+                     double *C, int ldc, int i0, int i1, int j0, int j1, int K) {
+    for (int kk = 0; kk < K; kk += TILE_SIZE) {
+        const int k_max = std::min(kk + TILE_SIZE, K);
+
+        for (int i = i0; i < i1; ++i) {
+            for (int j = j0; j < j1; ++j) {
+                double sum = C[i * ldc + j];
+                for (int k = kk; k < k_max; ++k) {
+                    sum += A[i * lda + k] * B_T[j * ldb + k];
+                }
+                C[i * ldc + j] = sum;
+            }
+        }
+    }
+}
+
+// Número de tiles (TILE_SIZE x TILE_SIZE) numa matriz de saída M x N
+inline int numTiles(int M, int N) {
+    return ((M + TILE_SIZE - 1) / TILE_SIZE) * ((N + TILE_SIZE - 1) / TILE_SIZE);
+}
+
+// Calcula o tile t (numeração por linhas de tiles) de C (M x N)
+inline void multTileIndex(const double *A, int lda, const double *B_T, int ldb,
+                          double *C, int ldc, int M, int N, int K, int t) {
+    const int tilesPerRow = (N + TILE_SIZE - 1) / TILE_SIZE;
+    const int ii = (t / tilesPerRow) * TILE_SIZE;
+    const int jj = (t % tilesPerRow) * TILE_SIZE;
+
+    multTile(A, lda, B_T, ldb, C, ldc,
+             ii, std::min(ii + TILE_SIZE, M),
+             jj, std::min(jj + TILE_SIZE, N), K);
+}
+
+// ------------------------------------------------------------
+// GEMM com epílogo fundido
+// C = act(alpha * A*B + beta * C + rowBias[i] + colBias[j])
+// Em vez de acumular diretamente em C e depois fazer passagens extra sobre C
+// (escala, bias, ativação), cada tile acumula num buffer local (fica em
+// registos/L1) e o epílogo é aplicado uma única vez, quando o tile é escrito.
+// Com beta == 0, C não é lido (pode ter lixo/NaN), como no BLAS.
+// ------------------------------------------------------------
+
+enum Activation { ACT_NONE, ACT_RELU, ACT_SIGMOID, ACT_TANH, ACT_GELU };
+
+struct Epilogue {
+    double alpha = 1.0;
+    double beta = 0.0;
+    const double *rowBias = nullptr;   // M valores, somado à linha i (ou nullptr)
+    const double *colBias = nullptr;   // N valores, somado à coluna j (ou nullptr)
+    Activation act = ACT_NONE;
+};
+
+inline double applyActivation(double x, Activation act) {
+    switch (act) {
+        case ACT_RELU:    return x > 0.0 ? x : 0.0;
+        case ACT_SIGMOID: return 1.0 / (1.0 + exp(-x));
+        case ACT_TANH:    return tanh(x);
+        case ACT_GELU:    return 0.5 * x * (1.0 + erf(x * M_SQRT1_2));
+        default:          return x;
+    }
+}
+
+// Valor final de C[i][j] a partir do acumulado acc = (A*B)[i][j]
+inline double epilogueValue(double acc, const double *c, int i, int j, const Epilogue &ep) {
+    double v = ep.alpha * acc;
+    if (ep.beta != 0.0) v += ep.beta * *c;
+    if (ep.rowBias) v += ep.rowBias[i];
+    if (ep.colBias) v += ep.colBias[j];
+    return applyActivation(v, ep.act);
+}
+
+// C (M x N) = epílogo(X), sem produto (X faz o papel de A*B)
+inline void applyEpilogue(const double *X, int ldx, double *C, int ldc, int M, int N,
+                          const Epilogue &ep, int numThreads) {
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < M; i++)
+        for (int j = 0; j < N; j++) {
+            double *c = C + (long) i * ldc + j;
+            *c = epilogueValue(X[(long) i * ldx + j], c, i, j, ep);
+        }
+}
+
+// Calcula o tile C[i0:i1, j0:j1] por completo (todo o K) e aplica o epílogo
+inline void multTileEpilogue(const double *A, int lda, const double *B_T, int ldb,
+                             double *C, int ldc, int i0, int i1, int j0, int j1, int K,
+                             const Epilogue &ep) {
+    double acc[TILE_SIZE][TILE_SIZE];
+    const int rows = i1 - i0, cols = j1 - j0;
+
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j) acc[i][j] = 0.0;
+
+    for (int kk = 0; kk < K; kk += TILE_SIZE) {
+        const int k_max = std::min(kk + TILE_SIZE, K);
+
+        for (int i = 0; i < rows; ++i) {
+            const double *a = A + (long) (i0 + i) * lda;
+            for (int j = 0; j < cols; ++j) {
+                const double *b = B_T + (long) (j0 + j) * ldb;
+                double sum = acc[i][j];
+                for (int k = kk; k < k_max; ++k) {
+                    sum += a[k] * b[k];
+                }
+                acc[i][j] = sum;
+            }
+        }
+    }
+
+    for (int i = 0; i < rows; ++i) {
+        double *c = C + (long) (i0 + i) * ldc + j0;
+        for (int j = 0; j < cols; ++j) {
+            c[j] = epilogueValue(acc[i][j], c + j, i0 + i, j0 + j, ep);
+        }
+    }
+}
+
+// C (M x N) = epílogo(A (M x K) * B), tiles distribuídos estaticamente
+inline void gemmFused(const double *A, int lda, const double *B_T, int ldb,
+                      double *C, int ldc, int M, int N, int K,
+                      const Epilogue &ep, int numThreads) {
+    const int tilesPerRow = (N + TILE_SIZE - 1) / TILE_SIZE;
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int t = 0; t < numTiles(M, N); t++) {
+        const int ii = (t / tilesPerRow) * TILE_SIZE;
+        const int jj = (t % tilesPerRow) * TILE_SIZE;
+        multTileEpilogue(A, lda, B_T, ldb, C, ldc,
+                         ii, std::min(ii + TILE_SIZE, M),
+                         jj, std::min(jj + TILE_SIZE, N), K, ep);
+    }
+}
+
+#endif // GEMM_H
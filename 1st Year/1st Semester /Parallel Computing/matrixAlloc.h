@@ -0,0 +1,130 @@
+#ifndef MATRIX_ALLOC_H
+#define MATRIX_ALLOC_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// ------------------------------------------------------------
+// Alocador para as matrizes (substitui o malloc do alloc())
+//  - alinhamento de 64 bytes (cache line / registo AVX-512) para loads vetoriais
+//  - páginas grandes opcionais (2 MiB): menos entradas na TLB para N grande
+//    HUGE_TRANSPARENT: mmap alinhado a 2 MiB + madvise(MADV_HUGEPAGE)
+//    HUGE_EXPLICIT:    mmap com MAP_HUGETLB (precisa de páginas reservadas em
+//                      /proc/sys/vm/nr_hugepages); se falhar cai para transparent
+//  - first touch paralelo: o kernel Linux coloca cada página no nó NUMA da
+//    thread que lhe escreve primeiro, por isso as páginas devem ser tocadas
+//    com a mesma partição que o kernel de cálculo usa depois.
+// Fora de Linux as páginas grandes são ignoradas (só alinhamento).
+// ------------------------------------------------------------
+
+#define MATRIX_ALIGN 64
+#define HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+enum HugePages { HUGE_NONE, HUGE_TRANSPARENT, HUGE_EXPLICIT };
+
+// Guardado nos 64 bytes antes dos dados, para o freeMatrix() saber como libertar
+struct AllocHeader {
+    void  *base;
+    size_t length;   // 0 => veio do posix_memalign
+    int    hugePages; // modo efetivamente usado (pode ter caído de EXPLICIT)
+};
+
+inline size_t roundUp(size_t x, size_t to) {
+    return (x + to - 1) / to * to;
+}
+
+#ifdef __linux__
+// Reserva length bytes alinhados a HUGE_PAGE_SIZE: pede a mais e corta as pontas
+inline void *mmapAligned(size_t length) {
+    size_t total = length + HUGE_PAGE_SIZE;
+    char *raw = (char *) mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+
+    char *start = (char *) roundUp((uintptr_t) raw, HUGE_PAGE_SIZE);
+    if (start > raw) munmap(raw, start - raw);
+    size_t tail = (raw + total) - (start + length);
+    if (tail > 0) munmap(start + length, tail);
+    return start;
+}
+#endif
+
+// Aloca elems doubles. Devolve NULL se não houver memória.
+inline double *allocMatrix(size_t elems, int hugePages) {
+    size_t bytes = elems * sizeof(double) + MATRIX_ALIGN; // + cabeçalho
+    void *base = NULL;
+    size_t length = 0;
+    int used = HUGE_NONE;
+
+#ifdef __linux__
+    if (hugePages == HUGE_EXPLICIT) {
+        length = roundUp(bytes, HUGE_PAGE_SIZE);
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED) base = NULL;
+        else used = HUGE_EXPLICIT;
+    }
+    if (base == NULL && hugePages != HUGE_NONE) {
+        length = roundUp(bytes, HUGE_PAGE_SIZE);
+        base = mmapAligned(length);
+        if (base != NULL) {
+            madvise(base, length, MADV_HUGEPAGE);
+            used = HUGE_TRANSPARENT;
+        }
+    }
+#endif
+
+    if (base == NULL) {
+        length = 0;
+        if (posix_memalign(&base, MATRIX_ALIGN, bytes) != 0) return NULL;
+    }
+
+    AllocHeader *h = (AllocHeader *) base;
+    h->base = base;
+    h->length = length;
+    h->hugePages = used;
+    return (double *) ((char *) base + MATRIX_ALIGN);
+}
+
+inline AllocHeader *allocHeader(double *p) {
+    return (AllocHeader *) ((char *) p - MATRIX_ALIGN);
+}
+
+// Modo de páginas que a alocação acabou por usar
+inline int allocHugePages(double *p) {
+    return allocHeader(p)->hugePages;
+}
+
+inline void freeMatrix(double *p) {
+    if (p == NULL) return;
+    AllocHeader *h = allocHeader(p);
+#ifdef __linux__
+    if (h->length > 0) {
+        munmap(h->base, h->length);
+        return;
+    }
+#endif
+    free(h->base);
+}
+
+// ------------------------------------------------------------
+// First touch paralelo de uma matriz rows x cols (escreve zeros)
+// schedule(static) sobre as linhas dá a cada thread um bloco contíguo de
+// linhas, a mesma partição que o cálculo OpenMP da V3 (por tiles de linhas).
+// Só serve para código que calcula na pool OpenMP (com OMP_PROC_BIND, para
+// as threads não mudarem de core): as versões com std::thread (V2, V4)
+// fazem o first touch nas suas próprias threads (ver touchTasks/pinThread
+// em workSteal.h).
+// ------------------------------------------------------------
+inline void firstTouch(double *p, int rows, int cols, int numThreads) {
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < rows; i++) {
+        memset(p + (size_t) i * cols, 0, cols * sizeof(double));
+    }
+}
+
+#endif // MATRIX_ALLOC_H
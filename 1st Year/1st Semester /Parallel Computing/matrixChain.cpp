@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <vector>
+
+#include "counterRng.h"
+#include "gemm.h"
+#include "matrixChain.h"
+
+// ------------------------------------------------------------
+// Epílogos fundidos e produto em cadeia
+// 1) Um GEMM seguido de escala (alpha, beta), bias por linha e por coluna e
+//    ReLU: versão com passagens separadas sobre C vs gemmFused().
+// 2) Cadeia M0*M1*M2*M3*M4 com formas diferentes (terminando no mesmo
+//    epílogo): da esquerda para a direita com temporários novos e passagens
+//    separadas vs chainPlan()/chainMultiply() com a pool reutilizada.
+// Os resultados das duas versões são comparados entre si.
+//
+// Uso: ./matrixChain [size] [threads] [reps]
+// ------------------------------------------------------------
+
+int sizeMatrix = 512;
+int numThreads = 2;
+int reps = 3;
+
+// Matriz rows x cols com valores em [-0.5, 0.5) da stream indicada
+double *randomMatrix(int rows, int cols, uint64_t stream) {
+    const uint64_t key = rngKey(RNG_SEED, stream);
+    double *m = allocMatrix((size_t) rows * cols, HUGE_TRANSPARENT);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < rows; i++)
+        for (int j = 0; j < cols; j++) {
+            const uint64_t idx = (uint64_t) i * cols + j;
+            m[idx] = rngUniform(key, idx) - 0.5;
+        }
+    return m;
+}
+
+// ------------------------------------------------------------
+// Versão sem fusão: C += A*B (B_T já transposta) como nas variantes
+// anteriores, e depois uma passagem sobre C por cada operação do epílogo
+// ------------------------------------------------------------
+void gemmPlain(const double *A, const double *B_T, double *C, int M, int N, int K) {
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int t = 0; t < numTiles(M, N); t++)
+        multTileIndex(A, K, B_T, K, C, N, M, N, K, t);
+}
+
+// Out = act(alpha*AB + beta*C0 + rowBias + colBias), em passagens separadas
+void epilogueUnfused(const double *AB, const double *C0, double *Out, int M, int N,
+                     const Epilogue &ep) {
+    const long n = (long) M * N;
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long x = 0; x < n; x++) Out[x] = ep.alpha * AB[x] + (C0 ? ep.beta * C0[x] : 0.0);
+
+    if (ep.rowBias) {
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++) Out[(long) i * N + j] += ep.rowBias[i];
+    }
+    if (ep.colBias) {
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++) Out[(long) i * N + j] += ep.colBias[j];
+    }
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long x = 0; x < n; x++) Out[x] = applyActivation(Out[x], ep.act);
+}
+
+double maxDiff(const double *x, const double *y, long n) {
+    double d = 0;
+    for (long i = 0; i < n; i++) d = std::max(d, fabs(x[i] - y[i]) / (1.0 + fabs(y[i])));
+    return d;
+}
+
+// ------------------------------------------------------------
+// 1) Um GEMM com epílogo
+// ------------------------------------------------------------
+int benchEpilogue() {
+    const int N = sizeMatrix;
+    const long elems = (long) N * N;
+    double *A = randomMatrix(N, N, 0), *B_T = randomMatrix(N, N, 1), *C0 = randomMatrix(N, N, 2);
+    double *rowBias = randomMatrix(1, N, 3), *colBias = randomMatrix(1, N, 4);
+    double *AB = allocMatrix(elems, HUGE_TRANSPARENT);
+    double *Cu = allocMatrix(elems, HUGE_TRANSPARENT);
+    double *Cf = allocMatrix(elems, HUGE_TRANSPARENT);
+
+    Epilogue ep;
+    ep.alpha = 0.5;
+    ep.beta = 2.0;
+    ep.rowBias = rowBias;
+    ep.colBias = colBias;
+    ep.act = ACT_RELU;
+
+    double tGemm = 1e30, tUnfused = 1e30, tFused = 1e30;
+    for (int r = 0; r < reps; r++) {
+        memset(AB, 0, elems * sizeof(double));
+        memcpy(Cf, C0, elems * sizeof(double));
+
+        double t0 = omp_get_wtime();
+        gemmPlain(A, B_T, AB, N, N, N);
+        double t1 = omp_get_wtime();
+        epilogueUnfused(AB, C0, Cu, N, N, ep);
+        double t2 = omp_get_wtime();
+        gemmFused(A, N, B_T, N, Cf, N, N, N, N, ep, numThreads);
+        double t3 = omp_get_wtime();
+
+        tGemm = std::min(tGemm, t1 - t0);
+        tUnfused = std::min(tUnfused, t2 - t0);
+        tFused = std::min(tFused, t3 - t2);
+    }
+
+    double err = maxDiff(Cf, Cu, elems);
+    printf("GEMM %d x %d x %d, alpha/beta + bias linha/coluna + ReLU\n", N, N, N);
+    printf("  só C += A*B:        %8.4f s\n", tGemm);
+    printf("  + passagens extra:  %8.4f s  (%.4f s no epílogo)\n", tUnfused, tUnfused - tGemm);
+    printf("  fundido:            %8.4f s  speedup %.2fx  diff=%.2e %s\n",
+           tFused, tUnfused / tFused, err, err < 1e-12 ? "OK" : "ERRO");
+
+    for (double *p : {A, B_T, C0, rowBias, colBias, AB, Cu, Cf}) freeMatrix(p);
+    return err < 1e-12 ? 0 : 1;
+}
+
+// ------------------------------------------------------------
+// 2) Cadeia de matrizes
+// ------------------------------------------------------------
+
+// Da esquerda para a direita, com temporários novos em cada produto
+void chainLeftToRight(const std::vector<int> &dims, const double *const *mats,
+                      double *C, const Epilogue &ep) {
+    const int n = (int) dims.size() - 1;
+    double *X = nullptr;  // produto acumulado, dims[0] x dims[k]
+
+    for (int k = 1; k < n; k++) {
+        const int M = dims[0], K = dims[k], N = dims[k + 1];
+        const double *left = k == 1 ? mats[0] : X;
+
+        double *B_T = (double *) malloc((size_t) N * K * sizeof(double));
+        transpose(mats[k], N, B_T, K, K, N, numThreads);
+
+        double *Y = (double *) calloc((size_t) M * N, sizeof(double));
+        gemmPlain(left, B_T, Y, M, N, K);
+
+        free(B_T);
+        free(X);
+        X = Y;
+    }
+    epilogueUnfused(X, nullptr, C, dims[0], dims[n], ep);
+    free(X);
+}
+
+int benchChain() {
+    const int s = sizeMatrix;
+    // Formas típicas de uma cadeia de projeções: a ordem importa muito
+    const std::vector<int> dims = {s, s / 8, s, s / 4, s, s / 16};
+    const int n = (int) dims.size() - 1;
+    const int M = dims[0], N = dims[n];
+
+    std::vector<double *> mats(n);
+    for (int i = 0; i < n; i++) mats[i] = randomMatrix(dims[i], dims[i + 1], 10 + i);
+    double *rowBias = randomMatrix(1, M, 20), *colBias = randomMatrix(1, N, 21);
+    double *Cref = allocMatrix((size_t) M * N, HUGE_TRANSPARENT);
+    double *Cout = allocMatrix((size_t) M * N, HUGE_TRANSPARENT);
+
+    Epilogue ep;
+    ep.alpha = 1.0 / s;
+    ep.rowBias = rowBias;
+    ep.colBias = colBias;
+    ep.act = ACT_TANH;
+
+    ChainPlan plan = chainPlan(dims);
+    ChainWorkspace ws;
+
+    double tLeft = 1e30, tChain = 1e30;
+    int failed = 0;
+    for (int r = 0; r < reps; r++) {
+        double t0 = omp_get_wtime();
+        chainLeftToRight(dims, mats.data(), Cref, ep);
+        double t1 = omp_get_wtime();
+        failed |= !chainMultiply(plan, mats.data(), Cout, ws, ep, numThreads);
+        double t2 = omp_get_wtime();
+        tLeft = std::min(tLeft, t1 - t0);
+        tChain = std::min(tChain, t2 - t1);
+    }
+
+    double err = failed ? INFINITY : maxDiff(Cout, Cref, (long) M * N);
+    printf("\nCadeia de %d matrizes, dims =", n);
+    for (int d : dims) printf(" %d", d);
+    printf("\n  ordem ótima: %s\n", plan.order.c_str());
+    printf("  flops: esquerda->direita %.3g, ótima %.3g (%.1fx menos)\n",
+           plan.leftToRightFlops, plan.flops, plan.leftToRightFlops / plan.flops);
+    printf("  pool: %d slots de %zu doubles, %zu passos\n",
+           plan.numSlots, plan.slotElems, plan.steps.size());
+    printf("  esquerda->direita:  %8.4f s\n", tLeft);
+    printf("  chainMultiply:      %8.4f s  speedup %.2fx  diff=%.2e %s\n",
+           tChain, tLeft / tChain, err, err < 1e-10 ? "OK" : "ERRO");
+
+    // Casos limite: uma só matriz (C = epílogo(M0)) e cadeia vazia (erro)
+    const std::vector<int> one = {dims[0], dims[1]};
+    ep.rowBias = rowBias;
+    ep.colBias = nullptr;
+    int ok = chainMultiply(one, mats.data(), Cout, ep, numThreads);
+    epilogueUnfused(mats[0], nullptr, Cref, dims[0], dims[1], ep);
+    double errOne = ok ? maxDiff(Cout, Cref, (long) dims[0] * dims[1]) : INFINITY;
+    int emptyFails = !chainMultiply(std::vector<int>{}, mats.data(), Cout, ep, numThreads);
+    printf("  uma matriz: diff=%.2e %s, cadeia vazia rejeitada: %s\n",
+           errOne, errOne < 1e-14 ? "OK" : "ERRO", emptyFails ? "OK" : "ERRO");
+
+    for (double *p : mats) freeMatrix(p);
+    for (double *p : {rowBias, colBias, Cref, Cout}) freeMatrix(p);
+    return (err < 1e-10 && errOne < 1e-14 && emptyFails) ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2) {
+        sizeMatrix = atoi(argv[1]);
+        if (sizeMatrix < 16) {
+            fprintf(stderr, "Invalid matrix size: %s\n", argv[1]);
+            return 1;
+        }
+    }
+    if (argc >= 3) {
+        numThreads = atoi(argv[2]);
+        if (numThreads <= 0) {
+            fprintf(stderr, "Invalid number of threads: %s\n", argv[2]);
+            return 1;
+        }
+    }
+    if (argc >= 4) reps = std::max(1, atoi(argv[3]));
+
+    printf("size=%d threads=%d reps=%d\n\n", sizeMatrix, numThreads, reps);
+    int bad = benchEpilogue();
+    bad |= benchChain();
+    return bad;
+}
@@ -0,0 +1,229 @@
+#ifndef MATRIX_CHAIN_H
+#define MATRIX_CHAIN_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "gemm.h"
+#include "transpose.h"
+#include "matrixAlloc.h"
+
+// ------------------------------------------------------------
+// Produto de uma cadeia de matrizes M0 * M1 * ... * Mn-1
+// Mi tem dims[i] x dims[i+1] (row-major, compacta).
+//
+// 1) chainPlan(): programação dinâmica clássica O(n^3) para a ordem dos
+//    produtos com menos flops, e depois uma lista de passos já com os buffers
+//    intermédios atribuídos (slots de uma pool fixa, reutilizados assim que o
+//    resultado deixa de ser preciso).
+// 2) chainMultiply(): executa os passos com gemmFused(); o epílogo (alpha,
+//    beta, bias, ativação) só é aplicado ao último produto, que escreve em C.
+//    Com uma só matriz, C = epílogo(M0). Sem matrizes devolve false.
+//
+// Layout: o kernel quer o operando da esquerda normal e o da direita
+// transposto. Um produto Z = X*Y pode ser escrito normal (A=X, B_T=Y^T) ou
+// transposto, Z^T = Y^T * X^T (A=Y^T, B_T=X): nos dois casos precisa de X
+// normal e de Y transposta. Assim cada intermédio é logo escrito no layout em
+// que vai ser consumido, e só as matrizes de entrada que aparecem à direita
+// é que são transpostas (uma vez, para um slot da pool).
+// ------------------------------------------------------------
+
+enum { CHAIN_TRANSPOSE, CHAIN_GEMM, CHAIN_EPILOGUE };
+
+#define CHAIN_OUT (-1)   // destino: a matriz de saída C
+#define CHAIN_TOUCH_ROW 512
+
+struct ChainStep {
+    int op;        // CHAIN_TRANSPOSE, CHAIN_GEMM ou CHAIN_EPILOGUE
+    int a, b;      // operandos: slot da pool (>= 0) ou matriz de entrada -(i+1)
+    int dst;       // slot da pool ou CHAIN_OUT
+    int M, N, K;   // GEMM: dst (M x N) = a (M x K) * b^T; TRANSPOSE/EPILOGUE: a é M x N
+};
+
+struct ChainPlan {
+    std::vector<int> dims;
+    std::vector<ChainStep> steps;
+    int numSlots = 0;
+    size_t slotElems = 0;     // tamanho de cada slot (o maior intermédio)
+    double flops = 0;         // 2*p*q*r somado pela ordem escolhida
+    double leftToRightFlops = 0;
+    std::string order;        // parênteses, ex: ((M0 M1) (M2 M3))
+};
+
+// Estado usado só durante a construção do plano
+struct ChainBuilder {
+    ChainPlan *plan;
+    std::vector<std::vector<int>> split;
+    std::vector<int> freeSlots;
+
+    int acquire() {
+        if (!freeSlots.empty()) {
+            int s = freeSlots.back();
+            freeSlots.pop_back();
+            return s;
+        }
+        return plan->numSlots++;
+    }
+
+    void release(int operand) {
+        if (operand >= 0) freeSlots.push_back(operand);
+    }
+
+    void use(size_t elems) {
+        if (elems > plan->slotElems) plan->slotElems = elems;
+    }
+
+    // Produto Mi..Mj, escrito transposto se transposed, em dst (ou num slot novo)
+    int build(int i, int j, bool transposed, int dst) {
+        const std::vector<int> &d = plan->dims;
+
+        if (i == j) {
+            if (!transposed) return -(i + 1);           // usada diretamente
+            int s = acquire();
+            use((size_t) d[i] * d[i + 1]);
+            plan->steps.push_back({CHAIN_TRANSPOSE, -(i + 1), 0, s, d[i], d[i + 1], 0});
+            return s;
+        }
+
+        const int k = split[i][j];
+        int left = build(i, k, false, 0);
+        int right = build(k + 1, j, true, 0);
+
+        // Os operandos só são libertados depois do produto: o destino não
+        // pode ser um deles
+        int out = dst == CHAIN_OUT ? CHAIN_OUT : acquire();
+        if (out != CHAIN_OUT) use((size_t) d[i] * d[j + 1]);
+
+        if (!transposed)
+            plan->steps.push_back({CHAIN_GEMM, left, right, out, d[i], d[j + 1], d[k + 1]});
+        else
+            plan->steps.push_back({CHAIN_GEMM, right, left, out, d[j + 1], d[i], d[k + 1]});
+
+        release(left);
+        release(right);
+        return out;
+    }
+
+    std::string order(int i, int j) {
+        if (i == j) return "M" + std::to_string(i);
+        int k = split[i][j];
+        return "(" + order(i, k) + " " + order(k + 1, j) + ")";
+    }
+};
+
+// Ordem ótima (mínimo de flops) e passos para dims.size()-1 matrizes
+// Sem matrizes o plano fica vazio (sem passos) e o chainMultiply() falha.
+inline ChainPlan chainPlan(const std::vector<int> &dims) {
+    ChainPlan plan;
+    plan.dims = dims;
+    const int n = (int) dims.size() - 1;
+    if (n < 1) {
+        fprintf(stderr, "chainPlan: a cadeia precisa de pelo menos 1 matriz\n");
+        return plan;
+    }
+    if (n == 1) {
+        plan.steps.push_back({CHAIN_EPILOGUE, -1, 0, CHAIN_OUT, dims[0], dims[1], 0});
+        plan.order = "M0";
+        return plan;
+    }
+
+    // cost[i][j]: menor custo para Mi..Mj; split[i][j]: onde partir
+    std::vector<std::vector<double>> cost(n, std::vector<double>(n, 0.0));
+    ChainBuilder b;
+    b.plan = &plan;
+    b.split.assign(n, std::vector<int>(n, 0));
+
+    for (int len = 2; len <= n; len++) {
+        for (int i = 0; i + len - 1 < n; i++) {
+            int j = i + len - 1;
+            cost[i][j] = -1;
+            for (int k = i; k < j; k++) {
+                double c = cost[i][k] + cost[k + 1][j] + 2.0 * dims[i] * dims[k + 1] * dims[j + 1];
+                if (cost[i][j] < 0 || c < cost[i][j]) {
+                    cost[i][j] = c;
+                    b.split[i][j] = k;
+                }
+            }
+        }
+    }
+    plan.flops = cost[0][n - 1];
+    for (int k = 1; k < n; k++)
+        plan.leftToRightFlops += 2.0 * dims[0] * dims[k] * dims[k + 1];
+
+    b.build(0, n - 1, false, CHAIN_OUT);
+    plan.order = b.order(0, n - 1);
+    return plan;
+}
+
+// ------------------------------------------------------------
+// Pool de buffers intermédios. Reservada uma vez e reutilizada entre
+// chamadas: só volta a alocar se um plano precisar de mais slots ou maiores.
+// ------------------------------------------------------------
+struct ChainWorkspace {
+    std::vector<double *> slots;
+    size_t slotElems = 0;
+
+    // Os slots são libertados no destrutor: uma cópia libertava-os duas vezes
+    ChainWorkspace() = default;
+    ChainWorkspace(const ChainWorkspace &) = delete;
+    ChainWorkspace &operator=(const ChainWorkspace &) = delete;
+
+    void reserve(const ChainPlan &plan, int numThreads) {
+        if (plan.slotElems > slotElems) {
+            release();
+            slotElems = roundUp(plan.slotElems, CHAIN_TOUCH_ROW);
+        }
+        // Os slots servem para intermédios de formas diferentes, por isso o
+        // first touch é só às fatias de CHAIN_TOUCH_ROW, repartidas pelas threads
+        while ((int) slots.size() < plan.numSlots) {
+            double *p = allocMatrix(slotElems, HUGE_TRANSPARENT);
+            firstTouch(p, (int) (slotElems / CHAIN_TOUCH_ROW), CHAIN_TOUCH_ROW, numThreads);
+            slots.push_back(p);
+        }
+    }
+
+    void release() {
+        for (double *p : slots) freeMatrix(p);
+        slots.clear();
+        slotElems = 0;
+    }
+
+    ~ChainWorkspace() { release(); }
+};
+
+// C = epílogo(M0 * M1 * ... * Mn-1), com mats[i] a apontar para Mi
+// Devolve false (sem tocar em C) se o plano não tiver passos
+inline bool chainMultiply(const ChainPlan &plan, const double *const *mats, double *C,
+                          ChainWorkspace &ws, const Epilogue &ep, int numThreads) {
+    if (plan.steps.empty()) return false;
+    ws.reserve(plan, numThreads);
+
+    auto operand = [&](int x) -> const double * {
+        return x >= 0 ? ws.slots[x] : mats[-x - 1];
+    };
+
+    const Epilogue plain;
+    for (const ChainStep &s : plan.steps) {
+        if (s.op == CHAIN_TRANSPOSE) {
+            transpose(operand(s.a), s.N, ws.slots[s.dst], s.M, s.M, s.N, numThreads);
+        } else if (s.op == CHAIN_EPILOGUE) {
+            applyEpilogue(operand(s.a), s.N, C, s.N, s.M, s.N, ep, numThreads);
+        } else {
+            double *dst = s.dst == CHAIN_OUT ? C : ws.slots[s.dst];
+            gemmFused(operand(s.a), s.K, operand(s.b), s.K, dst, s.N, s.M, s.N, s.K,
+                      s.dst == CHAIN_OUT ? ep : plain, numThreads);
+        }
+    }
+    return true;
+}
+
+// Versão de uma só chamada: planeia e usa uma pool temporária
+inline bool chainMultiply(const std::vector<int> &dims, const double *const *mats, double *C,
+                          const Epilogue &ep, int numThreads) {
+    ChainPlan plan = chainPlan(dims);
+    ChainWorkspace ws;
+    return chainMultiply(plan, mats, C, ws, ep, numThreads);
+}
+
+#endif // MATRIX_CHAIN_H
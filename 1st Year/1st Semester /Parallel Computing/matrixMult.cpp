@@ -2,6 +2,8 @@
 #include<stdlib.h>
 #include<omp.h>
 
+#include "counterRng.h"
+
 // Deixe sizeMatrix como variável (runtime), não macro
 int sizeMatrix = 512;
 int numThreads = 2;
@@ -16,12 +18,18 @@ void alloc() {
 }
 
 //Inicializa matrizes A e B com valores aleatórios e C com zeros
+//Gerador por contador (counterRng.h): paralelo e igual para qualquer nº de threads
 void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for num_threads(numThreads)
     for(int i=0; i<sizeMatrix; i++) {
         for(int j=0; j<sizeMatrix; j++) {
-            A[i*sizeMatrix+j] = rand();
-            B[i*sizeMatrix+j] = rand();
-            C[i*sizeMatrix+j] = 0;
+            const uint64_t idx = (uint64_t) i*sizeMatrix + j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0;
         }
     }
 }
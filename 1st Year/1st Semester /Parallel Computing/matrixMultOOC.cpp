@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <future>
+#include <string>
+
+#include "counterRng.h"
+#include "gemm.h"
+
+// ------------------------------------------------------------
+// Multiplicação out-of-core: as matrizes vivem em ficheiros binários
+// (doubles em row-major, sem cabeçalho) e só blocos delas passam pela RAM.
+//   A.bin   : N x N
+//   B_T.bin : N x N, B já transposta (como o B_T das outras versões)
+//   C.bin   : N x N, resultado
+// O orçamento de memória define a altura b dos blocos de linhas:
+//   2 blocos de A + 2 blocos de B_T + 2 blocos de C, cada um b x N doubles
+// (duplo buffer: enquanto se calcula com um, o outro está a ser lido/escrito)
+//
+// Uso: ./matrixMultOOC gen  <size> <dir>
+//      ./matrixMultOOC mult <size> <dir> [budgetMiB] [threads]
+// ------------------------------------------------------------
+
+int sizeMatrix = 1024;
+int numThreads = 2;
+long budgetMiB = 64;
+
+int fdA, fdB, fdC;
+int blockRows;          // b: linhas de A / B_T / C em cada bloco
+int numBlocks;
+
+double *Abuf[2], *Bbuf[2], *Cbuf[2];
+
+// Lê/escreve exatamente bytes (pread/pwrite podem devolver menos)
+void readFully(int fd, void *dst, size_t bytes, off_t offset) {
+    char *p = (char *) dst;
+    while (bytes > 0) {
+        ssize_t r = pread(fd, p, bytes, offset);
+        if (r <= 0) { perror("pread"); exit(1); }
+        p += r; bytes -= r; offset += r;
+    }
+}
+
+void writeFully(int fd, const void *src, size_t bytes, off_t offset) {
+    const char *p = (const char *) src;
+    while (bytes > 0) {
+        ssize_t w = pwrite(fd, p, bytes, offset);
+        if (w <= 0) { perror("pwrite"); exit(1); }
+        p += w; bytes -= w; offset += w;
+    }
+}
+
+int openMatrix(const std::string &dir, const char *name, int flags) {
+    std::string path = dir + "/" + name;
+    int fd = open(path.c_str(), flags, 0644);
+    if (fd < 0) { perror(path.c_str()); exit(1); }
+    return fd;
+}
+
+// Número de linhas do bloco blk (o último pode ser mais curto)
+int rowsOf(int blk) {
+    int start = blk * blockRows;
+    return (start + blockRows <= sizeMatrix) ? blockRows : sizeMatrix - start;
+}
+
+// Lê o bloco de linhas blk de um ficheiro para buf; devolve o tempo gasto
+double loadBlock(int fd, double *buf, int blk) {
+    double t0 = omp_get_wtime();
+    size_t rowBytes = sizeMatrix * sizeof(double);
+    readFully(fd, buf, rowsOf(blk) * rowBytes, (off_t) blk * blockRows * rowBytes);
+    return omp_get_wtime() - t0;
+}
+
+double storeBlock(int fd, const double *buf, int blk) {
+    double t0 = omp_get_wtime();
+    size_t rowBytes = sizeMatrix * sizeof(double);
+    writeFully(fd, buf, rowsOf(blk) * rowBytes, (off_t) blk * blockRows * rowBytes);
+    return omp_get_wtime() - t0;
+}
+
+// ------------------------------------------------------------
+// Gera A.bin e B_T.bin com valores aleatórios, linha a linha
+// O elemento (i,j) vem do gerador por contador (counterRng.h), por isso
+// cada linha é gerada em paralelo e os ficheiros não dependem das threads
+// ------------------------------------------------------------
+void generate(const std::string &dir) {
+    int fa = openMatrix(dir, "A.bin", O_WRONLY | O_CREAT | O_TRUNC);
+    int fb = openMatrix(dir, "B_T.bin", O_WRONLY | O_CREAT | O_TRUNC);
+    size_t rowBytes = sizeMatrix * sizeof(double);
+    double *row = (double *) malloc(rowBytes);
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    for (int i = 0; i < sizeMatrix; i++) {
+        const uint64_t base = (uint64_t) i * sizeMatrix;
+
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int j = 0; j < sizeMatrix; j++) row[j] = rngUniform(keyA, base + j);
+        writeFully(fa, row, rowBytes, (off_t) i * rowBytes);
+
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int j = 0; j < sizeMatrix; j++) row[j] = rngUniform(keyB, base + j);
+        writeFully(fb, row, rowBytes, (off_t) i * rowBytes);
+    }
+
+    free(row);
+    // Escreve os dados para o disco: páginas sujas não saem da page cache
+    // com POSIX_FADV_DONTNEED, e o mult leria cópias de RAM
+    fdatasync(fa);
+    fdatasync(fb);
+    close(fa);
+    close(fb);
+}
+
+// ------------------------------------------------------------
+// C[ib, jb] += A[ib, :] * B_T[jb, :]^T, com os blocos já em memória.
+// Os tiles do bloco são divididos pelas threads OpenMP.
+// ------------------------------------------------------------
+void multBlock(const double *Ablk, const double *Bblk, double *Cblk, int rows, int cols) {
+    const int N = sizeMatrix;
+    const int tiles = numTiles(rows, cols);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int t = 0; t < tiles; t++) {
+        multTileIndex(Ablk, N, Bblk, N, Cblk, N, rows, cols, N, t);
+    }
+}
+
+// ------------------------------------------------------------
+// Percorre os passos (ib, jb) por ordem. Enquanto o passo s calcula,
+// uma std::async já lê os blocos do passo s+1 para o outro buffer, e o bloco
+// de linhas de C anterior é escrito em background.
+// ------------------------------------------------------------
+void multOutOfCore() {
+    const int steps = numBlocks * numBlocks;
+    double ioTime = 0.0, waitTime = 0.0, computeTime = 0.0;
+
+    // Lê os blocos necessários ao passo s (o de A só muda quando ib muda)
+    auto fetch = [](int s) {
+        int ib = s / numBlocks, jb = s % numBlocks;
+        double t = 0.0;
+        if (jb == 0) t += loadBlock(fdA, Abuf[ib % 2], ib);
+        t += loadBlock(fdB, Bbuf[s % 2], jb);
+        return t;
+    };
+
+    double start = omp_get_wtime();
+    std::future<double> next = std::async(std::launch::async, fetch, 0);
+    std::future<double> writeback;
+
+    for (int s = 0; s < steps; s++) {
+        int ib = s / numBlocks, jb = s % numBlocks;
+        double *Cblk = Cbuf[ib % 2];
+
+        double w0 = omp_get_wtime();
+        ioTime += next.get();
+        waitTime += omp_get_wtime() - w0;
+
+        if (s + 1 < steps) next = std::async(std::launch::async, fetch, s + 1);
+
+        if (jb == 0) memset(Cblk, 0, (size_t) rowsOf(ib) * sizeMatrix * sizeof(double));
+
+        double c0 = omp_get_wtime();
+        multBlock(Abuf[ib % 2], Bbuf[s % 2], Cblk + jb * blockRows, rowsOf(ib), rowsOf(jb));
+        computeTime += omp_get_wtime() - c0;
+
+        if (jb == numBlocks - 1) {
+            // A escrita anterior (do outro Cbuf) tem de acabar antes de o reutilizar
+            if (writeback.valid()) {
+                double w1 = omp_get_wtime();
+                ioTime += writeback.get();
+                waitTime += omp_get_wtime() - w1;
+            }
+            writeback = std::async(std::launch::async, storeBlock, fdC, Cblk, ib);
+        }
+    }
+
+    double w0 = omp_get_wtime();
+    ioTime += writeback.get();
+    waitTime += omp_get_wtime() - w0;
+    double total = omp_get_wtime() - start;
+
+    // Fração do I/O escondida atrás do cálculo
+    double overlap = ioTime > 0.0 ? 1.0 - waitTime / ioTime : 1.0;
+    if (overlap < 0.0) overlap = 0.0;
+    double gflop = 2.0 * sizeMatrix * (double) sizeMatrix * sizeMatrix * 1e-9;
+
+    printf("size=%d budget=%ld MiB block=%d rows (%d x %d blocks) threads=%d\n",
+           sizeMatrix, budgetMiB, blockRows, numBlocks, numBlocks, numThreads);
+    printf("total   %10.4f s  (%.2f GFLOP/s)\n", total, gflop / total);
+    printf("compute %10.4f s\n", computeTime);
+    printf("I/O     %10.4f s  (%.2f GB/s)\n", ioTime,
+           ((numBlocks + 2.0) * sizeMatrix * (double) sizeMatrix * sizeof(double) * 1e-9) / ioTime);
+    printf("stalled %10.4f s  -> %.1f%% of I/O overlapped with compute\n", waitTime, 100.0 * overlap);
+}
+
+// Confere algumas entradas de C lendo as linhas correspondentes dos ficheiros
+int check() {
+    const int N = sizeMatrix;
+    double *a = (double *) malloc(N * sizeof(double));
+    double *b = (double *) malloc(N * sizeof(double));
+    int ok = 1;
+
+    for (int s = 0; s < 8 && ok; s++) {
+        int i = (int) ((long) s * 7919 % N), j = (int) ((long) s * 104729 % N);
+        double c;
+        readFully(fdA, a, N * sizeof(double), (off_t) i * N * sizeof(double));
+        readFully(fdB, b, N * sizeof(double), (off_t) j * N * sizeof(double));
+        readFully(fdC, &c, sizeof(double), ((off_t) i * N + j) * sizeof(double));
+        double ref = 0.0;
+        for (int k = 0; k < N; k++) ref += a[k] * b[k];
+        if (fabs(ref - c) > 1e-9 * fabs(ref)) {
+            fprintf(stderr, "C[%d,%d] = %f, expected %f\n", i, j, c, ref);
+            ok = 0;
+        }
+    }
+
+    free(a);
+    free(b);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4 || (strcmp(argv[1], "gen") != 0 && strcmp(argv[1], "mult") != 0)) {
+        fprintf(stderr, "Usage: %s gen <size> <dir>\n"
+                        "       %s mult <size> <dir> [budgetMiB] [threads]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    sizeMatrix = std::atoi(argv[2]);
+    if (sizeMatrix <= 0) {
+        fprintf(stderr, "Invalid matrix size: %s\n", argv[2]);
+        return 1;
+    }
+    std::string dir = argv[3];
+
+    if (strcmp(argv[1], "gen") == 0) {
+        generate(dir);
+        return 0;
+    }
+
+    if (argc >= 5) {
+        budgetMiB = std::atol(argv[4]);
+        if (budgetMiB <= 0) {
+            fprintf(stderr, "Invalid memory budget: %s\n", argv[4]);
+            return 1;
+        }
+    }
+
+    if (argc >= 6) {
+        numThreads = std::atoi(argv[5]);
+        if (numThreads <= 0) {
+            fprintf(stderr, "Invalid thread count: %s\n", argv[5]);
+            return 1;
+        }
+    }
+
+    // 6 blocos de b x N doubles têm de caber no orçamento
+    long rows = budgetMiB * 1024 * 1024 / (6L * sizeMatrix * sizeof(double));
+    if (rows < 1) {
+        fprintf(stderr, "Budget too small: need at least %.2f MiB for size %d\n",
+                6.0 * sizeMatrix * sizeof(double) / (1024.0 * 1024.0), sizeMatrix);
+        return 1;
+    }
+    blockRows = rows < sizeMatrix ? (int) rows : sizeMatrix;
+    numBlocks = (sizeMatrix + blockRows - 1) / blockRows;
+
+    fdA = openMatrix(dir, "A.bin", O_RDONLY);
+    fdB = openMatrix(dir, "B_T.bin", O_RDONLY);
+    fdC = openMatrix(dir, "C.bin", O_RDWR | O_CREAT | O_TRUNC);
+
+    off_t expected = (off_t) sizeMatrix * sizeMatrix * sizeof(double);
+    if (lseek(fdA, 0, SEEK_END) < expected || lseek(fdB, 0, SEEK_END) < expected) {
+        fprintf(stderr, "Input files are smaller than %d x %d doubles\n", sizeMatrix, sizeMatrix);
+        return 1;
+    }
+
+#ifdef POSIX_FADV_DONTNEED
+    // Tira os ficheiros da page cache para medir I/O real e não cópias de RAM.
+    // DONTNEED só larga páginas limpas, por isso primeiro escreve as sujas
+    // (ficheiros acabados de gerar ou copiados)
+    fdatasync(fdA);
+    fdatasync(fdB);
+    posix_fadvise(fdA, 0, 0, POSIX_FADV_DONTNEED);
+    posix_fadvise(fdB, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+
+    for (int i = 0; i < 2; i++) {
+        Abuf[i] = (double *) malloc((size_t) blockRows * sizeMatrix * sizeof(double));
+        Bbuf[i] = (double *) malloc((size_t) blockRows * sizeMatrix * sizeof(double));
+        Cbuf[i] = (double *) malloc((size_t) blockRows * sizeMatrix * sizeof(double));
+    }
+
+    multOutOfCore();
+
+    if (!check()) return 1;
+
+    double c;
+    readFully(fdC, &c, sizeof(double), ((off_t) (sizeMatrix / 2) * sizeMatrix + 5) * sizeof(double));
+    printf("C[center,5] = %f\n", c);
+
+    for (int i = 0; i < 2; i++) {
+        free(Abuf[i]);
+        free(Bbuf[i]);
+        free(Cbuf[i]);
+    }
+    close(fdA);
+    close(fdB);
+    close(fdC);
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+#include <numeric> // para std::lcm
+#include <vector>
+#include <algorithm>
+
+#include "counterRng.h"
+#include "gemm.h"
+#include "transpose.h"
+
+// ------------------------------------------------------------
+// Multiplicação distribuída com MPI: algoritmo SUMMA numa grelha 2D pr x pc
+// Cada rank (r, c) guarda os blocos (r, c) de A, B e C, de
+// (N/pr) x (N/pc) elementos. Para cada painel k de largura até b:
+//  - o dono da coluna k de A faz broadcast do painel de A na sua linha da grelha
+//  - o dono da linha k de B faz broadcast do painel de B na sua coluna
+//  - todos fazem C_loc += A_painel * B_painel com o kernel por blocos (gemm.h)
+// Os broadcasts são não bloqueantes (MPI_Ibcast) e com duplo buffer: o painel
+// k+1 viaja enquanto o painel k é multiplicado.
+//
+// Como A e B vêm do gerador por contador, cada rank gera só o seu bloco e os
+// dados são os mesmos da versão sequencial com o mesmo N.
+//
+// Uso: mpirun -np P ./matrixMultSUMMA <size> [panel] [strong|weak]
+//  strong: size é o N global (o mesmo para qualquer P)
+//  weak:   size é o N para 1 processo; N global = size * cbrt(P), para o
+//          trabalho por rank (2*N^3/P) ficar constante. A memória por rank
+//          (~N^2/P) diminui com P^(1/3); com N = size * sqrt(P) seria ao
+//          contrário (memória constante, trabalho a crescer com sqrt(P))
+// ------------------------------------------------------------
+
+int sizeMatrix = 1024;
+int panelWidth = 64;
+int weak = 0;
+
+int rank, numProcs;
+int gridRows, gridCols, myRow, myCol;
+MPI_Comm gridComm, rowComm, colComm;
+
+int mLoc, nLoc;                  // bloco local: mLoc x nLoc
+double *A, *B, *C;               // blocos locais (row-major)
+double *Apanel[2], *Bpanel[2];   // mLoc x b e b x nLoc
+double *BpanelT;                 // nLoc x b (painel de B transposto para o kernel)
+
+// Painéis: início e largura. Um painel nunca atravessa a fronteira entre dois
+// blocos de A (colunas, de nLoc em nLoc) nem de B (linhas, de mLoc em mLoc),
+// por isso cada painel tem um único dono em cada linha/coluna da grelha.
+std::vector<int> panelStart, panelSize;
+
+void buildPanels() {
+    for (int k0 = 0; k0 < sizeMatrix; ) {
+        int end = std::min(k0 + panelWidth, sizeMatrix);
+        end = std::min(end, (k0 / nLoc + 1) * nLoc);
+        end = std::min(end, (k0 / mLoc + 1) * mLoc);
+        panelStart.push_back(k0);
+        panelSize.push_back(end - k0);
+        k0 = end;
+    }
+}
+
+// Cria a grelha 2D e os comunicadores de linha e de coluna
+void setupGrid() {
+    int dims[2] = { 0, 0 }, periods[2] = { 0, 0 }, coords[2];
+    MPI_Dims_create(numProcs, 2, dims);
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &gridComm);
+    MPI_Comm_rank(gridComm, &rank);
+    MPI_Cart_coords(gridComm, rank, 2, coords);
+    gridRows = dims[0]; gridCols = dims[1];
+    myRow = coords[0];  myCol = coords[1];
+
+    int keepCols[2] = { 0, 1 }, keepRows[2] = { 1, 0 };
+    MPI_Cart_sub(gridComm, keepCols, &rowComm); // mesma linha, rank = coluna
+    MPI_Cart_sub(gridComm, keepRows, &colComm); // mesma coluna, rank = linha
+}
+
+void alloc() {
+    A = (double *) malloc((size_t) mLoc * nLoc * sizeof(double));
+    B = (double *) malloc((size_t) mLoc * nLoc * sizeof(double));
+    C = (double *) malloc((size_t) mLoc * nLoc * sizeof(double));
+    for (int i = 0; i < 2; i++) {
+        Apanel[i] = (double *) malloc((size_t) mLoc * panelWidth * sizeof(double));
+        Bpanel[i] = (double *) malloc((size_t) panelWidth * nLoc * sizeof(double));
+    }
+    BpanelT = (double *) malloc((size_t) nLoc * panelWidth * sizeof(double));
+}
+
+// Cada rank gera o seu bloco a partir dos índices globais (i, j)
+void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+    const int i0 = myRow * mLoc, j0 = myCol * nLoc;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < mLoc; i++) {
+        for (int j = 0; j < nLoc; j++) {
+            const uint64_t idx = (uint64_t) (i0 + i) * sizeMatrix + (j0 + j);
+            A[i * nLoc + j] = rngUniform(keyA, idx);
+            B[i * nLoc + j] = rngUniform(keyB, idx);
+            C[i * nLoc + j] = 0.0;
+        }
+    }
+}
+
+// Inicia o broadcast do painel p (colunas de A / linhas de B k0 .. k0+b-1)
+void startPanel(int p, int buf, MPI_Request req[2]) {
+    const int b = panelSize[p];
+    const int k0 = panelStart[p];
+    const int ownerCol = k0 / nLoc, ownerRow = k0 / mLoc;
+
+    // Painel de A: colunas k0..k0+b do bloco do dono, copiadas para contíguo
+    if (myCol == ownerCol) {
+        const int off = k0 % nLoc;
+        for (int i = 0; i < mLoc; i++)
+            memcpy(Apanel[buf] + (size_t) i * b, A + (size_t) i * nLoc + off, b * sizeof(double));
+    }
+    // Painel de B: linhas k0..k0+b do bloco do dono, já contíguas
+    if (myRow == ownerRow) {
+        const int off = k0 % mLoc;
+        memcpy(Bpanel[buf], B + (size_t) off * nLoc, (size_t) b * nLoc * sizeof(double));
+    }
+
+    MPI_Ibcast(Apanel[buf], mLoc * b, MPI_DOUBLE, ownerCol, rowComm, &req[0]);
+    MPI_Ibcast(Bpanel[buf], b * nLoc, MPI_DOUBLE, ownerRow, colComm, &req[1]);
+}
+
+// Os tiles de cada painel são feitos em PROGRESS_CHUNKS fatias; entre fatias
+// chama-se MPI_Testall para a biblioteca MPI avançar os broadcasts pendentes
+// (sem thread de progresso, um MPI_Ibcast só anda dentro de chamadas MPI)
+#define PROGRESS_CHUNKS 8
+
+// C_loc += Apanel * Bpanel com o kernel por tiles (threads OpenMP)
+void multPanel(int p, int buf, MPI_Request *pending) {
+    const int b = panelSize[p];
+    transpose(Bpanel[buf], nLoc, BpanelT, b, b, nLoc, omp_get_max_threads());
+
+    const int tiles = numTiles(mLoc, nLoc);
+    const int chunk = (tiles + PROGRESS_CHUNKS - 1) / PROGRESS_CHUNKS;
+    for (int t0 = 0; t0 < tiles; t0 += chunk) {
+        const int t1 = std::min(t0 + chunk, tiles);
+
+        #pragma omp parallel for schedule(static)
+        for (int t = t0; t < t1; t++) {
+            multTileIndex(Apanel[buf], b, BpanelT, b, C, nLoc, mLoc, nLoc, b, t);
+        }
+
+        if (pending != NULL) {
+            int done;
+            MPI_Testall(2, pending, &done, MPI_STATUSES_IGNORE);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// SUMMA com sobreposição: enquanto o painel p é multiplicado, os broadcasts
+// do painel p+1 já estão a decorrer. Devolve o tempo parado à espera da rede.
+// ------------------------------------------------------------
+double summa() {
+    const int panels = (int) panelStart.size();
+    MPI_Request req[2][2];
+    double waitTime = 0.0;
+
+    startPanel(0, 0, req[0]);
+    for (int p = 0; p < panels; p++) {
+        const int buf = p % 2;
+
+        double w0 = MPI_Wtime();
+        MPI_Waitall(2, req[buf], MPI_STATUSES_IGNORE);
+        waitTime += MPI_Wtime() - w0;
+
+        MPI_Request *pending = NULL;
+        if (p + 1 < panels) {
+            startPanel(p + 1, 1 - buf, req[1 - buf]);
+            pending = req[1 - buf];
+        }
+
+        multPanel(p, buf, pending);
+    }
+    return waitTime;
+}
+
+// Confere algumas entradas do bloco local com o produto escalar gerado
+// diretamente do RNG (não precisa de mais nenhum rank)
+int check() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+    int ok = 1;
+
+    for (int s = 0; s < 4; s++) {
+        const int i = (int) ((long) s * 7919 % mLoc), j = (int) ((long) s * 104729 % nLoc);
+        const long gi = (long) myRow * mLoc + i, gj = (long) myCol * nLoc + j;
+        double ref = 0.0;
+        for (long k = 0; k < sizeMatrix; k++)
+            ref += rngUniform(keyA, gi * sizeMatrix + k) * rngUniform(keyB, k * sizeMatrix + gj);
+        if (fabs(ref - C[i * nLoc + j]) > 1e-9 * fabs(ref)) {
+            fprintf(stderr, "rank %d: C[%ld,%ld] = %f, expected %f\n", rank, gi, gj, C[i * nLoc + j], ref);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    // Só a thread principal faz chamadas MPI (fora das regiões OpenMP)
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+    if (provided < MPI_THREAD_FUNNELED) {
+        fprintf(stderr, "MPI library does not support MPI_THREAD_FUNNELED\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    setupGrid();
+
+    if (argc >= 2) sizeMatrix = std::atoi(argv[1]);
+    if (argc >= 3) panelWidth = std::atoi(argv[2]);
+    if (argc >= 4) weak = (strcmp(argv[3], "weak") == 0);
+    if (sizeMatrix <= 0 || panelWidth <= 0) {
+        if (rank == 0) fprintf(stderr, "Usage: %s <size> [panel] [strong|weak]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // N tem de se dividir pela grelha; no modo weak cresce com cbrt(P)
+    if (weak) sizeMatrix = (int) lround(sizeMatrix * cbrt((double) numProcs));
+    const int step = std::lcm(gridRows, gridCols);
+    sizeMatrix = (sizeMatrix + step - 1) / step * step;
+    mLoc = sizeMatrix / gridRows;
+    nLoc = sizeMatrix / gridCols;
+
+    panelWidth = std::min(panelWidth, std::min(mLoc, nLoc));
+    buildPanels();
+
+    alloc();
+    init();
+
+    MPI_Barrier(gridComm);
+    double t0 = MPI_Wtime();
+    double waitTime = summa();
+    double elapsed = MPI_Wtime() - t0;
+
+    // O tempo que conta é o do rank mais lento
+    double maxTime, maxWait;
+    MPI_Reduce(&elapsed, &maxTime, 1, MPI_DOUBLE, MPI_MAX, 0, gridComm);
+    MPI_Reduce(&waitTime, &maxWait, 1, MPI_DOUBLE, MPI_MAX, 0, gridComm);
+
+    int ok = check(), allOk;
+    MPI_Reduce(&ok, &allOk, 1, MPI_INT, MPI_LAND, 0, gridComm);
+
+    if (rank == 0) {
+        double gflops = 2.0 * sizeMatrix * (double) sizeMatrix * sizeMatrix * 1e-9 / maxTime;
+        printf("mode=%s procs=%d grid=%dx%d threads=%d N=%d panels=%d time=%.4f wait=%.4f gflops=%.2f %s\n",
+               weak ? "weak" : "strong", numProcs, gridRows, gridCols, omp_get_max_threads(),
+               sizeMatrix, (int) panelStart.size(), maxTime, maxWait, gflops, allOk ? "OK" : "WRONG");
+    }
+
+    free(A); free(B); free(C); free(BpanelT);
+    for (int i = 0; i < 2; i++) { free(Apanel[i]); free(Bpanel[i]); }
+    MPI_Comm_free(&rowComm);
+    MPI_Comm_free(&colComm);
+    MPI_Comm_free(&gridComm);
+    MPI_Finalize();
+
+    int exitCode = 0;
+    if (rank == 0 && !allOk) exitCode = 1;
+    return exitCode;
+}
@@ -1,33 +1,83 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <thread>
 #include <algorithm> // para std::min
 
+#include "counterRng.h"
+#include "matrixAlloc.h"
+#include "transpose.h"
+#include "workSteal.h"
+
 int sizeMatrix = 512;
 int numThreads = 2;
 
 double *A, *B, *B_T, *C;
 
+// ------------------------------------------------------------
+// Linhas [start, end) de A e C que a thread threadID calcula
+// ------------------------------------------------------------
+void rowChunk(int threadID, int &start, int &end) {
+    taskChunk(threadID, sizeMatrix, numThreads, start, end);
+}
+
+// ------------------------------------------------------------
+// First touch: cada std::thread escreve zeros nas suas linhas, para essas
+// páginas ficarem no nó NUMA onde vão ser calculadas. Com OMP_PROC_BIND /
+// OMP_PLACES (bindThreads()), esta thread e a do matrixMult() com o mesmo
+// threadID ficam fixadas no mesmo place; sem isso, fica ao cuidado do SO.
+// B e B_T são lidas por todas as threads; ficam repartidas da mesma forma.
+// ------------------------------------------------------------
+void touchRows(int threadID) {
+    if (bindThreads()) pinThread(threadID);
+    int start, end;
+    rowChunk(threadID, start, end);
+
+    const size_t offset = (size_t) start * sizeMatrix;
+    const size_t bytes = (size_t) (end - start) * sizeMatrix * sizeof(double);
+    memset(A + offset, 0, bytes);
+    memset(B + offset, 0, bytes);
+    memset(B_T + offset, 0, bytes);
+    memset(C + offset, 0, bytes);
+}
+
 // ------------------------------------------------------------
 // Aloca espaço na memória para A, B, B_T (transposta) e C
 // Esta versão usa a matrix transposta B_T para melhorar locality, o que permite uma pesquisa contigua na memória
+// Alinhado a 64 bytes, com páginas grandes (matrixAlloc.h) e first touch
+// feito pelas mesmas std::threads que calculam (touchRows)
 // ------------------------------------------------------------
 void alloc() {
-    A   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    B   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    B_T = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    C   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
+    const size_t elems = (size_t) sizeMatrix * sizeMatrix;
+    A   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B_T = allocMatrix(elems, HUGE_TRANSPARENT);
+    C   = allocMatrix(elems, HUGE_TRANSPARENT);
+
+    std::thread tx[numThreads];
+    for (int i = 0; i < numThreads; i++)
+        tx[i] = std::thread(touchRows, i);
+
+    for (int i = 0; i < numThreads; i++)
+        tx[i].join();
 }
 
 // ------------------------------------------------------------
 // Inicializa A e B com valores aleatórios, e C com zeros
+// Cada elemento (i,j) vem do gerador por contador (counterRng.h), por isso
+// a inicialização é paralela e dá os mesmos dados para qualquer nº de threads
 // ------------------------------------------------------------
 void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
     for (int i = 0; i < sizeMatrix; i++) {
         for (int j = 0; j < sizeMatrix; j++) {
-            A[i * sizeMatrix + j] = rand() / (double) RAND_MAX;
-            B[i * sizeMatrix + j] = rand() / (double) RAND_MAX;
-            C[i * sizeMatrix + j] = 0.0;
+            const uint64_t idx = (uint64_t) i * sizeMatrix + j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0.0;
         }
     }
 }
@@ -36,13 +86,10 @@ void init() {
 // Transpõe a matriz B para melhorar *spatial locality*
 // Agora B_T[j*sizeMatrix + i] = B[i*sizeMatrix + j]
 // Assim, B_T é percorrida por linhas (contíguo em memória)
+// A transposição é cache-oblivious e paralela (ver transpose.h)
 // ------------------------------------------------------------
 void transposeB() {
-    for (int i = 0; i < sizeMatrix; i++) {
-        for (int j = 0; j < sizeMatrix; j++) {
-            B_T[j * sizeMatrix + i] = B[i * sizeMatrix + j];
-        }
-    }
+    transpose(B, sizeMatrix, B_T, sizeMatrix, sizeMatrix, sizeMatrix, numThreads);
 }
 
 // ------------------------------------------------------------
@@ -50,9 +97,9 @@ void transposeB() {
 // Cada thread processa um conjunto contíguo de linhas de A
 // ------------------------------------------------------------
 void matrixMult(int threadID) {
-    int chunk = sizeMatrix / numThreads;
-    int start = threadID * chunk;
-    int end   = (threadID == numThreads - 1) ? sizeMatrix : start + chunk;
+    if (bindThreads()) pinThread(threadID);
+    int start, end;
+    rowChunk(threadID, start, end);
 
     for (int i = start; i < end; i++) {               
         for (int k = 0; k < sizeMatrix; k++) {        
@@ -95,10 +142,10 @@ int main(int argc, char **argv) {
 
     printf("C[center,5] = %f\n", C[(sizeMatrix / 2) * sizeMatrix + 5]);
 
-    free(A);
-    free(B);
-    free(B_T);
-    free(C);
+    freeMatrix(A);
+    freeMatrix(B);
+    freeMatrix(B_T);
+    freeMatrix(C);
 
     return 0;
 }
@@ -1,10 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h>
-#include <algorithm> // para std::min
 
+#include "counterRng.h"
+#include "gemm.h"
+#include "matrixAlloc.h"
+#include "transpose.h"
 
-#define TILE_SIZE 32
 int sizeMatrix = 512;
 int numThreads = 2;
 
@@ -13,23 +15,38 @@ double *A, *B, *B_T, *C;
 // ------------------------------------------------------------
 // Aloca espaço na memória para A, B, B_T (transposta) e C
 // Esta versão usa a matrix transposta B_T para melhorar locality, o que permite uma pesquisa contigua na memória
+// Alinhado a 64 bytes, com páginas grandes e first touch paralelo (matrixAlloc.h),
+// para as páginas ficarem no nó NUMA das threads que as vão usar
 // ------------------------------------------------------------
 void alloc() {
-    A   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    B   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    B_T = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
-    C   = (double *) malloc(sizeMatrix * sizeMatrix * sizeof(double));
+    const size_t elems = (size_t) sizeMatrix * sizeMatrix;
+    A   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B_T = allocMatrix(elems, HUGE_TRANSPARENT);
+    C   = allocMatrix(elems, HUGE_TRANSPARENT);
+
+    firstTouch(A,   sizeMatrix, sizeMatrix, numThreads);
+    firstTouch(B,   sizeMatrix, sizeMatrix, numThreads);
+    firstTouch(B_T, sizeMatrix, sizeMatrix, numThreads);
+    firstTouch(C,   sizeMatrix, sizeMatrix, numThreads);
 }
 
 // ------------------------------------------------------------
 // Inicializa A e B com valores aleatórios, e C com zeros
+// Cada elemento (i,j) vem do gerador por contador (counterRng.h), por isso
+// a inicialização é paralela e dá os mesmos dados para qualquer nº de threads
 // ------------------------------------------------------------
 void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
     for (int i = 0; i < sizeMatrix; i++) {
         for (int j = 0; j < sizeMatrix; j++) {
-            A[i * sizeMatrix + j] = rand() / (double) RAND_MAX;
-            B[i * sizeMatrix + j] = rand() / (double) RAND_MAX;
-            C[i * sizeMatrix + j] = 0.0;
+            const uint64_t idx = (uint64_t) i * sizeMatrix + j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0.0;
         }
     }
 }
@@ -38,43 +55,25 @@ void init() {
 // Transpõe a matriz B para melhorar *spatial locality*
 // Agora B_T[j*sizeMatrix + i] = B[i*sizeMatrix + j]
 // Assim, B_T é percorrida por linhas (contíguo em memória)
+// A transposição é cache-oblivious e paralela (ver transpose.h)
 // ------------------------------------------------------------
 void transposeB() {
-    for (int i = 0; i < sizeMatrix; i++) {
-        for (int j = 0; j < sizeMatrix; j++) {
-            B_T[j * sizeMatrix + i] = B[i * sizeMatrix + j];
-        }
-    }
+    transpose(B, sizeMatrix, B_T, sizeMatrix, sizeMatrix, sizeMatrix, numThreads);
 }
 
 // ------------------------------------------------------------
 // Multiplicação de matrizes paralelizada com OpenMP (com B transposta)
-// Paralelizamos pelos blocos (ii,jj); cada thread acumula localmente e
-// escreve em regiões distintas de C, evitando data races.
+// Paralelizamos pelos tiles (ii,jj) de C, numerados por linhas (o mesmo que
+// collapse(2) sobre ii e jj); cada tile é calculado por multTile() (gemm.h)
+// e escreve numa região distinta de C, evitando data races.
 // ------------------------------------------------------------
 void matrixMultBlocked() {
     const int N = sizeMatrix;
+    const int tiles = numTiles(N, N);
 
-    // Paraleliza pelos blocos de linhas e colunas
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int ii = 0; ii < N; ii += TILE_SIZE) {
-        for (int jj = 0; jj < N; jj += TILE_SIZE) {
-            for (int kk = 0; kk < N; kk += TILE_SIZE) {
-                const int i_max = std::min(ii + TILE_SIZE, N);
-                const int j_max = std::min(jj + TILE_SIZE, N);
-                const int k_max = std::min(kk + TILE_SIZE, N);
-
-                for (int i = ii; i < i_max; ++i) {
-                    for (int j = jj; j < j_max; ++j) {
-                        double sum = C[i * N + j];
-                        for (int k = kk; k < k_max; ++k) {
-                            sum += A[i * N + k] * B_T[j * N + k];
-                        }
-                        C[i * N + j] = sum;
-                    }
-                }
-            }
-        }
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < tiles; t++) {
+        multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
     }
 }
 
@@ -105,10 +104,10 @@ int main(int argc, char **argv) {
 
     printf("C[center,5] = %f\n", C[(sizeMatrix / 2) * sizeMatrix + 5]);
 
-    free(A);
-    free(B);
-    free(B_T);
-    free(C);
+    freeMatrix(A);
+    freeMatrix(B);
+    freeMatrix(B_T);
+    freeMatrix(C);
 
     return 0;
 }
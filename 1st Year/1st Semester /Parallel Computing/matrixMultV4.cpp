@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "gemm.h"
+#include "counterRng.h"
+#include "matrixAlloc.h"
+#include "transpose.h"
+#include "workSteal.h"
+
+int sizeMatrix = 512;
+int numThreads = 2;
+
+double *A, *B, *B_T, *C;
+
+// ------------------------------------------------------------
+// Aloca espaço na memória para A, B, B_T (transposta) e C
+// Alinhado a 64 bytes, com páginas grandes (matrixAlloc.h). O first touch é
+// feito por std::threads com a mesma partição dos workers (touchTasks), cada
+// uma nos tiles do seu bloco inicial, para as páginas ficarem no nó NUMA da
+// thread que as vai usar (tiles roubados são a exceção). Com OMP_PROC_BIND /
+// OMP_PLACES as threads de touch e os workers são fixados nos mesmos places.
+// ------------------------------------------------------------
+void touchTile(int t) {
+    const int N = sizeMatrix;
+    const int tilesPerRow = (N + TILE_SIZE - 1) / TILE_SIZE;
+    const int ii = (t / tilesPerRow) * TILE_SIZE, i1 = std::min(ii + TILE_SIZE, N);
+    const int jj = (t % tilesPerRow) * TILE_SIZE, j1 = std::min(jj + TILE_SIZE, N);
+
+    for (int i = ii; i < i1; i++)
+        memset(C + (size_t) i * N + jj, 0, (j1 - jj) * sizeof(double));
+
+    // Linhas inteiras de A (e de B, B_T, repartidas da mesma forma) ficam
+    // com a thread do primeiro tile dessa faixa de linhas
+    if (jj == 0) {
+        for (int i = ii; i < i1; i++) {
+            memset(A   + (size_t) i * N, 0, N * sizeof(double));
+            memset(B   + (size_t) i * N, 0, N * sizeof(double));
+            memset(B_T + (size_t) i * N, 0, N * sizeof(double));
+        }
+    }
+}
+
+void alloc() {
+    const size_t elems = (size_t) sizeMatrix * sizeMatrix;
+    A   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B_T = allocMatrix(elems, HUGE_TRANSPARENT);
+    C   = allocMatrix(elems, HUGE_TRANSPARENT);
+
+    touchTasks(numTiles(sizeMatrix, sizeMatrix), numThreads, touchTile, bindThreads());
+}
+
+// ------------------------------------------------------------
+// Inicializa A e B com valores aleatórios, e C com zeros
+// Cada elemento (i,j) vem do gerador por contador (counterRng.h), por isso
+// a inicialização é paralela e dá os mesmos dados para qualquer nº de threads
+// ------------------------------------------------------------
+void init() {
+    const uint64_t keyA = rngKey(RNG_SEED, 0);
+    const uint64_t keyB = rngKey(RNG_SEED, 1);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < sizeMatrix; i++) {
+        for (int j = 0; j < sizeMatrix; j++) {
+            const uint64_t idx = (uint64_t) i * sizeMatrix + j;
+            A[idx] = rngUniform(keyA, idx);
+            B[idx] = rngUniform(keyB, idx);
+            C[idx] = 0.0;
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Transpõe a matriz B: B_T[j*sizeMatrix + i] = B[i*sizeMatrix + j]
+// (transposição cache-oblivious e paralela, ver transpose.h)
+// ------------------------------------------------------------
+void transposeB() {
+    transpose(B, sizeMatrix, B_T, sizeMatrix, sizeMatrix, sizeMatrix, numThreads);
+}
+
+// ------------------------------------------------------------
+// Multiplicação por tiles (i,j) de C com work stealing entre std::threads
+// Ao contrário da V2 (chunk estático de linhas por thread), uma thread
+// atrasada não trava as restantes: os tiles dela são roubados.
+// ------------------------------------------------------------
+StealStats matrixMultStealing() {
+    const int N = sizeMatrix;
+    return runWorkStealing(numTiles(N, N), numThreads, [N](int t, int) {
+        multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
+    }, bindThreads());
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) {
+        sizeMatrix = std::atoi(argv[1]);
+        if (sizeMatrix <= 0) {
+            fprintf(stderr, "Invalid matrix size: %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    if (argc >= 3) {
+        numThreads = std::atoi(argv[2]);
+        if (numThreads <= 0) {
+            fprintf(stderr, "Invalid thread count: %s\n", argv[2]);
+            return 1;
+        }
+    }
+
+    alloc();
+    init();
+    transposeB();
+
+    StealStats stats = matrixMultStealing();
+
+    printf("C[center,5] = %f\n", C[(sizeMatrix / 2) * sizeMatrix + 5]);
+#ifdef DEBUG
+    for (int i = 0; i < numThreads; i++)
+        fprintf(stderr, "T%d: %d tiles (%d roubados)\n", i, stats.executed[i], stats.stolen[i]);
+#else
+    (void) stats;
+#endif
+
+    freeMatrix(A);
+    freeMatrix(B);
+    freeMatrix(B_T);
+    freeMatrix(C);
+
+    return 0;
+}
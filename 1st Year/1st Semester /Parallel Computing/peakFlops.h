@@ -0,0 +1,45 @@
+#ifndef PEAK_FLOPS_H
+#define PEAK_FLOPS_H
+
+#include <stdio.h>
+#include <omp.h>
+
+// ------------------------------------------------------------
+// Pico de GFLOP/s: PEAK_CHAINS cadeias independentes de acc = acc*m + c por
+// thread, vetorizadas, que escondem a latência da FPU.
+// O resultado depende das flags com que é compilado: com -O3 sem -march é
+// só SSE2 e sem FMA (o modo ISO -std=c++17 desliga a contração a*b+c).
+// Por isso é static: o roofline.cpp inclui-o com as flags normais (pico
+// deste build) e o rooflinePeak.cpp com -march=native (pico da máquina),
+// e cada unidade de tradução fica com a sua cópia.
+// ------------------------------------------------------------
+
+#define PEAK_CHAINS 32
+
+static double peakFlopsProbe(int numThreads, int reps) {
+    const long iters = 20000000;
+    double best = 0.0;
+
+    for (int r = 0; r < reps; r++) {
+        double sink = 0.0;
+        double t0 = omp_get_wtime();
+        #pragma omp parallel num_threads(numThreads) reduction(+:sink)
+        {
+            double acc[PEAK_CHAINS];
+            for (int l = 0; l < PEAK_CHAINS; l++) acc[l] = 1.0 + l * 1e-3;
+            const double m = 0.999999, c = 1e-6;
+            for (long it = 0; it < iters; it++) {
+                #pragma omp simd
+                for (int l = 0; l < PEAK_CHAINS; l++) acc[l] = acc[l] * m + c;
+            }
+            for (int l = 0; l < PEAK_CHAINS; l++) sink += acc[l];
+        }
+        double t = omp_get_wtime() - t0;
+        if (sink == 42.0) printf(" "); // impede que o ciclo seja eliminado
+        double g = 2.0 * PEAK_CHAINS * iters * numThreads * 1e-9 / t;
+        if (g > best) best = g;
+    }
+    return best;
+}
+
+#endif // PEAK_FLOPS_H
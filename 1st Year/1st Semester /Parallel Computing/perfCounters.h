@@ -0,0 +1,135 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ------------------------------------------------------------
+// Contadores de hardware dentro do programa (perf_event_open)
+// Ao contrário de "perf stat ./prog", só medem a região entre perfStart() e
+// perfStop(), ou seja o kernel, sem o init() e o transposeB().
+//
+// Threads: um contador perf só conta a thread que o abriu (e as threads que
+// ela criar depois, com inherit). Como a pool OpenMP já existe, abrimos um
+// conjunto de contadores em cada thread OpenMP; com inherit, os da thread
+// principal também apanham as std::threads criadas depois (work stealing).
+// Se o kernel/hardware não deixar (VMs, perf_event_paranoid), o evento fica
+// marcado como inválido e o resto continua a funcionar.
+// ------------------------------------------------------------
+
+enum PerfEvent { PC_CYCLES, PC_INSTRUCTIONS, PC_L1D_MISSES, PC_LLC_MISSES, PC_DTLB_MISSES, PC_NUM };
+
+inline const char *perfEventNames[PC_NUM] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses"
+};
+
+struct PerfSample {
+    long long count[PC_NUM];
+    bool valid[PC_NUM];
+    double seconds;
+};
+
+inline std::vector<int> perfFds;   // PC_NUM descritores por thread (-1 se falhou)
+inline double perfStartTime;
+
+#ifdef __linux__
+inline int perfOpenEvent(int ev) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    switch (ev) {
+        case PC_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PC_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PC_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PC_LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PC_DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+// Abre os contadores em cada uma das numThreads threads OpenMP
+inline void perfInit(int numThreads) {
+    perfFds.assign((size_t) numThreads * PC_NUM, -1);
+#ifdef __linux__
+    #pragma omp parallel num_threads(numThreads)
+    {
+        int t = omp_get_thread_num();
+        for (int ev = 0; ev < PC_NUM; ev++)
+            perfFds[t * PC_NUM + ev] = perfOpenEvent(ev);
+    }
+#endif
+}
+
+inline void perfStart() {
+#ifdef __linux__
+    for (int fd : perfFds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    perfStartTime = omp_get_wtime();
+}
+
+// Pára os contadores e soma-os por todas as threads
+inline PerfSample perfStop() {
+    PerfSample s;
+    s.seconds = omp_get_wtime() - perfStartTime;
+    for (int ev = 0; ev < PC_NUM; ev++) { s.count[ev] = 0; s.valid[ev] = false; }
+
+#ifdef __linux__
+    for (size_t i = 0; i < perfFds.size(); i++) {
+        int fd = perfFds[i];
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long v;
+        if (read(fd, &v, sizeof(v)) == sizeof(v)) {
+            s.count[i % PC_NUM] += v;
+            s.valid[i % PC_NUM] = true;
+        }
+    }
+#endif
+    return s;
+}
+
+inline void perfClose() {
+#ifdef __linux__
+    for (int fd : perfFds)
+        if (fd >= 0) close(fd);
+#endif
+    perfFds.clear();
+}
+
+// Escreve o valor de um evento num campo CSV (vazio se não houve contador)
+inline void perfCsvField(FILE *f, const PerfSample &s, int ev) {
+    if (s.valid[ev]) fprintf(f, ",%lld", s.count[ev]);
+    else             fprintf(f, ",");
+}
+
+#endif // PERF_COUNTERS_H
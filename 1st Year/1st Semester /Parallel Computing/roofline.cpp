@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <functional>
+#include <algorithm> // para std::min
+
+#include "batchedGemm.h"
+#include "counterRng.h"
+#include "gemm.h"
+#include "matrixAlloc.h"
+#include "peakFlops.h"
+#include "perfCounters.h"
+#include "workSteal.h"
+#include "27oct/reduce.h"
+
+// ------------------------------------------------------------
+// Relatório roofline das variantes de GEMM e de redução
+// 1. mede os picos da máquina: GFLOP/s (mul+add em cadeias independentes,
+//    vetorizadas, compiladas com -march=native) e GB/s (triad STREAM
+//    paralela). O pico do mesmo código com as flags deste build (sem -march)
+//    também vai para o CSV (build_peak_gflops), para se ver quanto fica por
+//    usar das instruções vetoriais/FMA do CPU
+// 2. corre cada variante com perfStart()/perfStop() só à volta do kernel
+// 3. calcula GFLOP/s, GB/s e intensidade aritmética (FLOP/byte) sempre com o
+//    modelo de tráfego mínimo (cada matriz/vetor lido ou escrito uma vez), em
+//    qualquer máquina. Dados que cabem na cache podem passar acima do teto de
+//    memória (>100%). Os LLC misses * 64 vão para uma coluna à parte, só
+//    informativa: o evento genérico de cache misses não conta writebacks nem
+//    (na maioria dos cores) as linhas trazidas pelo prefetcher, por isso
+//    subestima muito o tráfego dos kernels em streaming
+// 4. coloca a variante no roofline: teto = min(pico FLOP/s, AI * pico GB/s)
+// O resultado vai para um CSV (uma linha por variante) e para o terminal.
+//
+// Uso: ./roofline [size] [threads] [csv] [reps]
+// ------------------------------------------------------------
+
+int sizeMatrix = 1024;
+int numThreads = 2;
+int reps = 3;
+const char *csvPath = "roofline.csv";
+
+long vecSize = 1L << 24;          // elementos dos vetores das reduções
+double peakGflops, peakGbs, buildPeakGflops;
+FILE *csv;
+
+double *A, *B_T, *C, *x, *y;
+
+// ------------------------------------------------------------
+// Picos da máquina
+// ------------------------------------------------------------
+
+// Pico da máquina (rooflinePeak.cpp, compilado com -march=native)
+double measurePeakFlopsNative(int numThreads, int reps);
+
+double measurePeakBandwidth() {
+    const long n = 1L << 25; // 3 x 256 MiB: bem acima da LLC
+    double *a = allocMatrix(n, HUGE_TRANSPARENT);
+    double *b = allocMatrix(n, HUGE_TRANSPARENT);
+    double *c = allocMatrix(n, HUGE_TRANSPARENT);
+    firstTouch(a, 1024, n / 1024, numThreads);
+    firstTouch(b, 1024, n / 1024, numThreads);
+    firstTouch(c, 1024, n / 1024, numThreads);
+
+    double best = 0.0;
+    for (int r = 0; r < reps; r++) {
+        double t0 = omp_get_wtime();
+        #pragma omp parallel for simd schedule(static) num_threads(numThreads)
+        for (long i = 0; i < n; i++) c[i] = a[i] + 3.0 * b[i];
+        double t = omp_get_wtime() - t0;
+        double g = 3.0 * n * sizeof(double) * 1e-9 / t;
+        if (g > best) best = g;
+    }
+
+    freeMatrix(a); freeMatrix(b); freeMatrix(c);
+    return best;
+}
+
+// ------------------------------------------------------------
+// Medição de uma variante e escrita no CSV
+// ------------------------------------------------------------
+void measure(const char *name, const char *kind, long n, double flops, double modelBytes,
+             std::function<void()> setup, std::function<void()> kernel) {
+    PerfSample best;
+    best.seconds = 1e30;
+
+    setup();
+    kernel(); // aquecimento (páginas, caches, pool de threads)
+    for (int r = 0; r < reps; r++) {
+        setup();
+        perfStart();
+        kernel();
+        PerfSample s = perfStop();
+        if (s.seconds < best.seconds) best = s;
+    }
+
+    const double gflops = flops * 1e-9 / best.seconds;
+    const double gbs = modelBytes * 1e-9 / best.seconds;
+    const double ai = flops / modelBytes;
+    const double roof = std::min(peakGflops, ai * peakGbs);
+    const char *bound = (ai * peakGbs < peakGflops) ? "memory" : "compute";
+
+    printf("%-22s %10.4f s %9.2f GFLOP/s %8.2f GB/s  AI %7.3f  roof %8.2f  %5.1f%%  %s\n",
+           name, best.seconds, gflops, gbs, ai, roof, 100.0 * gflops / roof, bound);
+
+    fprintf(csv, "%s,%s,%ld,%d,%.6f,%.4f,%.4f,%.5f,%.0f", name, kind, n, numThreads,
+            best.seconds, gflops, gbs, ai, modelBytes);
+    if (best.valid[PC_LLC_MISSES])
+        fprintf(csv, ",%.0f", best.count[PC_LLC_MISSES] * 64.0);
+    else
+        fprintf(csv, ",");
+    for (int ev = 0; ev < PC_NUM; ev++) perfCsvField(csv, best, ev);
+    if (best.valid[PC_CYCLES] && best.valid[PC_INSTRUCTIONS] && best.count[PC_CYCLES] > 0)
+        fprintf(csv, ",%.3f", (double) best.count[PC_INSTRUCTIONS] / best.count[PC_CYCLES]);
+    else
+        fprintf(csv, ",");
+    fprintf(csv, ",%.4f,%.4f,%.4f,%.4f,%.2f,%s\n", peakGflops, buildPeakGflops, peakGbs, roof,
+            100.0 * gflops / roof, bound);
+    fflush(csv);
+}
+
+// ------------------------------------------------------------
+// Variantes
+// ------------------------------------------------------------
+void gemmVariants() {
+    const int N = sizeMatrix;
+    const size_t elems = (size_t) N * N;
+    A   = allocMatrix(elems, HUGE_TRANSPARENT);
+    B_T = allocMatrix(elems, HUGE_TRANSPARENT);
+    C   = allocMatrix(elems, HUGE_TRANSPARENT);
+    firstTouch(A, N, N, numThreads);
+    firstTouch(B_T, N, N, numThreads);
+    firstTouch(C, N, N, numThreads);
+
+    const uint64_t keyA = rngKey(RNG_SEED, 0), keyB = rngKey(RNG_SEED, 1);
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            A[(size_t) i * N + j]   = rngUniform(keyA, (uint64_t) i * N + j);
+            B_T[(size_t) i * N + j] = rngUniform(keyB, (uint64_t) i * N + j);
+        }
+    }
+
+    const double flops = 2.0 * N * (double) N * N;
+    const double bytes = 4.0 * elems * sizeof(double); // A, B_T, C lida e escrita
+    auto zeroC = [&]() { firstTouch(C, N, N, numThreads); };
+
+    // V2: linhas contíguas por thread, produto escalar sem blocos
+    measure("gemm_rows", "gemm", N, flops, bytes, zeroC, [&]() {
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                double sum = 0.0;
+                for (int k = 0; k < N; k++) sum += A[(size_t) i * N + k] * B_T[(size_t) j * N + k];
+                C[(size_t) i * N + j] = sum;
+            }
+        }
+    });
+
+    // V3: tiles com schedule(static)
+    measure("gemm_blocked_static", "gemm", N, flops, bytes, zeroC, [&]() {
+        const int tiles = numTiles(N, N);
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (int t = 0; t < tiles; t++) multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
+    });
+
+    // V4: tiles com work stealing. As std::threads herdam a afinidade da
+    // thread principal, que com OMP_PROC_BIND=true está presa a um só core;
+    // com o binding ativo (bindThreads()) o worker i fixa-se no place i do
+    // OpenMP, o mesmo da thread OpenMP i, seja qual for o cpuset ou a
+    // numeração dos CPUs (pinThread em workSteal.h avisa se falhar).
+    measure("gemm_blocked_steal", "gemm", N, flops, bytes, zeroC, [&]() {
+        runWorkStealing(numTiles(N, N), numThreads, [&](int t, int) {
+            multTileIndex(A, N, B_T, N, C, N, N, N, N, t);
+        }, bindThreads());
+    });
+
+    // Lote de produtos 8x8x8 com o mesmo volume de dados de uma matriz N x N
+    const int batch = (int) (elems / 64) / BATCH_LANES * BATCH_LANES;
+    double *Ai = allocMatrix(interleavedSize(8, 8, batch), HUGE_TRANSPARENT);
+    double *Bi = allocMatrix(interleavedSize(8, 8, batch), HUGE_TRANSPARENT);
+    double *Ci = allocMatrix(interleavedSize(8, 8, batch), HUGE_TRANSPARENT);
+    memcpy(Ai, A, interleavedSize(8, 8, batch) * sizeof(double));
+    memcpy(Bi, B_T, interleavedSize(8, 8, batch) * sizeof(double));
+    measure("gemm_batched_8x8x8", "gemm", 8, 2.0 * 512 * batch, 4.0 * 64 * batch * sizeof(double),
+            [&]() { memset(Ci, 0, interleavedSize(8, 8, batch) * sizeof(double)); },
+            [&]() { gemmBatched<8, 8, 8>(Ai, Bi, Ci, batch, numThreads); });
+
+    freeMatrix(Ai); freeMatrix(Bi); freeMatrix(Ci);
+    freeMatrix(A); freeMatrix(B_T); freeMatrix(C);
+}
+
+void reductionVariants() {
+    const long n = vecSize;
+    x = allocMatrix(n, HUGE_TRANSPARENT);
+    y = allocMatrix(n, HUGE_TRANSPARENT);
+    const uint64_t kx = rngKey(RNG_SEED, 2), ky = rngKey(RNG_SEED, 3);
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long i = 0; i < n; i++) { x[i] = rngUniform(kx, i); y[i] = rngUniform(ky, i); }
+
+    volatile double sink;
+    auto none = []() {};
+    const double flops = 2.0 * n, bytes = 2.0 * n * sizeof(double);
+
+    measure("dot_omp_reduction", "reduction", n, flops, bytes, none, [&]() {
+        double dot = 0.0;
+        #pragma omp parallel for reduction(+:dot) num_threads(numThreads)
+        for (long i = 0; i < n; i++) dot += x[i] * y[i];
+        sink = dot;
+    });
+    measure("dot_fast", "reduction", n, flops, bytes, none, [&]() {
+        sink = reduce_dot(x, y, n, REDUCE_FAST, numThreads);
+    });
+    measure("dot_repro", "reduction", n, flops, bytes, none, [&]() {
+        sink = reduce_dot(x, y, n, REDUCE_REPRO, numThreads);
+    });
+    measure("sum_repro", "reduction", n, (double) n, n * (double) sizeof(double), none, [&]() {
+        sink = reduce_sum(x, n, REDUCE_REPRO, numThreads);
+    });
+    (void) sink;
+
+    freeMatrix(x); freeMatrix(y);
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) sizeMatrix = atoi(argv[1]);
+    if (argc >= 3) numThreads = atoi(argv[2]);
+    if (argc >= 4) csvPath    = argv[3];
+    if (argc >= 5) reps       = atoi(argv[4]);
+    if (sizeMatrix <= 0 || numThreads <= 0 || reps <= 0) {
+        fprintf(stderr, "Usage: %s [size] [threads] [csv] [reps]\n", argv[0]);
+        return 1;
+    }
+
+    csv = fopen(csvPath, "w");
+    if (csv == NULL) { perror(csvPath); return 1; }
+    fprintf(csv, "variant,kind,n,threads,seconds,gflops,gbs,ai,model_bytes,llc_bytes");
+    for (int ev = 0; ev < PC_NUM; ev++) fprintf(csv, ",%s", perfEventNames[ev]);
+    fprintf(csv, ",ipc,peak_gflops,build_peak_gflops,peak_gbs,roof_gflops,pct_of_roof,bound\n");
+
+    perfInit(numThreads);
+    int available = 0;
+    for (int fd : perfFds) available += (fd >= 0);
+    if (available == 0)
+        fprintf(stderr, "perf_event_open unavailable: counter columns left empty\n");
+
+    peakGflops = measurePeakFlopsNative(numThreads, reps);
+    buildPeakGflops = peakFlopsProbe(numThreads, reps);
+    peakGbs = measurePeakBandwidth();
+    printf("threads=%d  peak %.2f GFLOP/s (this build: %.2f)  %.2f GB/s  ridge AI %.3f FLOP/byte\n",
+           numThreads, peakGflops, buildPeakGflops, peakGbs, peakGflops / peakGbs);
+
+    gemmVariants();
+    reductionVariants();
+
+    perfClose();
+    fclose(csv);
+    printf("CSV written to %s\n", csvPath);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+#SBATCH --nodes=1
+#SBATCH --ntasks=10
+#SBATCH --exclusive
+#SBATCH --time=00:10:00
+#SBATCH --partition=cpar
+
+# Roofline report (make build/roofline): counters are read inside the program,
+# only around each kernel, so no "perf stat" wrapper is needed.
+# perf_event_paranoid must allow user-space counting (<= 2).
+#
+# The binding below applies to the OpenMP variants. gemm_blocked_steal runs
+# on std::threads, which inherit the (single-core) mask of the bound master
+# thread; since binding is on, worker i re-pins itself to OpenMP place i
+# (pinThread in workSteal.h), the same place OpenMP thread i gets. This holds
+# whatever CPUs the job's cpuset allows; a failed pin is reported on stderr.
+
+module load gcc/11.2.0
+
+export OMP_PROC_BIND=true
+export OMP_PLACES=threads
+
+SIZE=${1:-2048}
+
+for t in 1 2 4 8; do
+    ./build/roofline $SIZE $t roofline_${t}t.csv
+done
+
+echo "Finished"
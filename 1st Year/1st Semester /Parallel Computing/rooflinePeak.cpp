@@ -0,0 +1,11 @@
+#include "peakFlops.h"
+
+// ------------------------------------------------------------
+// Pico de GFLOP/s da máquina para o roofline.cpp
+// Compilado à parte com NATIVE_FLAGS (-march=native -ffp-contract=fast, ver
+// Makefile), para usar as instruções vetoriais e o FMA que o CPU tiver,
+// enquanto o resto do roofline mantém as flags dos outros programas.
+// ------------------------------------------------------------
+double measurePeakFlopsNative(int numThreads, int reps) {
+    return peakFlopsProbe(numThreads, reps);
+}
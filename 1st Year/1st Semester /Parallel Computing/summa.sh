@@ -0,0 +1,53 @@
+#!/bin/sh
+#SBATCH --nodes=1
+#SBATCH --ntasks=4
+#SBATCH --exclusive
+#SBATCH --time=00:10:00
+#SBATCH --partition=cpar
+
+# Strong and weak scaling of matrixMultSUMMA (make build/matrixMultSUMMA)
+# Runs on a single node too: mpirun starts the processes locally.
+# Usage: sh summa.sh [size] [maxProcs]
+# Weak scaling keeps the work per process constant: N = size * cbrt(P),
+# so 2*N^3/P flops per process (memory per process shrinks as P^(-1/3)).
+# With more nodes in the allocation, raise --nodes/--ntasks and maxProcs.
+
+module load gcc/11.2.0 2>/dev/null
+module load openmpi 2>/dev/null
+
+SIZE=${1:-1024}
+MAXP=${2:-4}
+EXE=./build/matrixMultSUMMA
+
+# One OpenMP thread per process, so P processes use P cores
+export OMP_NUM_THREADS=1
+export OMP_PROC_BIND=true
+
+# MPIRUN_FLAGS="--oversubscribe --allow-run-as-root" for containers / laptops
+run() {
+    mpirun $MPIRUN_FLAGS -np "$1" $EXE "$SIZE" 64 "$2" | grep '^mode='
+}
+
+# Speedup and efficiency relative to the 1-process run:
+#   strong: S = T1/Tp, E = S/p       weak: E = (GFLOP/s_p / p) / GFLOP/s_1 (= T1/Tp)
+report() {
+    awk '{
+        for (i = 1; i <= NF; i++) { split($i, kv, "="); v[kv[1]] = kv[2] }
+        p = v["procs"]; t = v["time"]; g = v["gflops"]
+        if (NR == 1) { t1 = t; g1 = g }
+        if (v["mode"] == "strong") { s = t1 / t; e = s / p }
+        else                       { s = g / g1; e = s / p }
+        printf "%-6s P=%-3d grid=%-5s N=%-6d time=%8.4f s  %7.2f GFLOP/s  speedup=%5.2f  eff=%5.1f%%  (%s)\n",
+               v["mode"], p, v["grid"], v["N"], t, g, s, 100 * e, $NF
+    }'
+}
+
+for mode in strong weak; do
+    p=1
+    while [ $p -le $MAXP ]; do
+        run $p $mode
+        p=$((p * 2))
+    done | report
+done
+
+echo "Finished"
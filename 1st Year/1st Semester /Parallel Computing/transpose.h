@@ -0,0 +1,127 @@
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// ------------------------------------------------------------
+// Transposição e packing reutilizáveis (substituem o ciclo duplo ingénuo
+// do transposeB(), que escreve com stride N e falha a cache para N grande)
+// ------------------------------------------------------------
+
+// Abaixo deste tamanho (em elementos) o bloco cabe na L1 e deixa de se dividir:
+// 32x32 doubles = 8 KiB de origem + 8 KiB de destino
+#define TRANSPOSE_BASE 1024
+
+// Blocos maiores do que isto (em elementos) geram uma task OpenMP própria
+#define TRANSPOSE_TASK_MIN (256 * 256)
+
+// Caso base: escreve dst por linhas (contíguo), o que o compilador vetoriza
+inline void transposeBase(const double *src, int lds, double *dst, int ldd,
+                          int r0, int r1, int c0, int c1) {
+    for (int j = c0; j < c1; ++j) {
+        double *d = dst + (long) j * ldd;
+        #pragma omp simd
+        for (int i = r0; i < r1; ++i) {
+            d[i] = src[(long) i * lds + j];
+        }
+    }
+}
+
+// Cache-oblivious: divide sempre a maior dimensão ao meio até o bloco caber
+// na cache, sem depender do tamanho da cache de cada máquina.
+// As duas metades são independentes, por isso uma delas vira task.
+inline void transposeRec(const double *src, int lds, double *dst, int ldd,
+                         int r0, int r1, int c0, int c1) {
+    const int rows = r1 - r0;
+    const int cols = c1 - c0;
+    const long area = (long) rows * cols;
+
+    if (area <= TRANSPOSE_BASE) {
+        transposeBase(src, lds, dst, ldd, r0, r1, c0, c1);
+        return;
+    }
+
+    if (rows >= cols) {
+        const int rm = r0 + rows / 2;
+        #pragma omp task if(area > TRANSPOSE_TASK_MIN)
+        transposeRec(src, lds, dst, ldd, r0, rm, c0, c1);
+        transposeRec(src, lds, dst, ldd, rm, r1, c0, c1);
+    } else {
+        const int cm = c0 + cols / 2;
+        #pragma omp task if(area > TRANSPOSE_TASK_MIN)
+        transposeRec(src, lds, dst, ldd, r0, r1, c0, cm);
+        transposeRec(src, lds, dst, ldd, r0, r1, cm, c1);
+    }
+    #pragma omp taskwait
+}
+
+// dst[j*ldd + i] = src[i*lds + j], para src com rows x cols
+// Se já estivermos dentro de uma região paralela, corre na thread atual.
+inline void transpose(const double *src, int lds, double *dst, int ldd,
+                      int rows, int cols, int numThreads) {
+#ifdef _OPENMP
+    if (!omp_in_parallel() && numThreads > 1) {
+        #pragma omp parallel num_threads(numThreads)
+        #pragma omp single
+        transposeRec(src, lds, dst, ldd, 0, rows, 0, cols);
+        return;
+    }
+#endif
+    (void) numThreads;
+    transposeRec(src, lds, dst, ldd, 0, rows, 0, cols);
+}
+
+// ------------------------------------------------------------
+// Packing em painéis (layout usado pelos kernels de registos)
+// Painel de A: MR linhas consecutivas, guardadas coluna a coluna (k-major)
+//   dst[p*MR*K + k*MR + r] = A[(p*MR + r)*lda + k]
+// Painel de B: NR colunas consecutivas, guardadas linha a linha (k-major)
+//   dst[q*NR*K + k*NR + c] = B[k*ldb + q*NR + c]
+// O último painel é completado com zeros, para o kernel não ter casos especiais.
+// Cada painel é independente, por isso são distribuídos pelas threads.
+// ------------------------------------------------------------
+
+// Número de doubles necessários para o resultado do packing
+inline long packedSize(int rowsOrCols, int K, int panel) {
+    return (long) ((rowsOrCols + panel - 1) / panel) * panel * K;
+}
+
+inline void packA(const double *A, int lda, double *dst, int M, int K, int MR, int numThreads) {
+    const int panels = (M + MR - 1) / MR;
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int p = 0; p < panels; ++p) {
+        double *d = dst + (long) p * MR * K;
+        for (int kk = 0; kk < K; kk += MR) {
+            const int k_max = kk + MR < K ? kk + MR : K;
+            // Pequeno bloco MR x MR: lê linhas de A, escreve colunas do painel
+            for (int r = 0; r < MR; ++r) {
+                const int i = p * MR + r;
+                for (int k = kk; k < k_max; ++k) {
+                    d[(long) k * MR + r] = (i < M) ? A[(long) i * lda + k] : 0.0;
+                }
+            }
+        }
+    }
+}
+
+inline void packB(const double *B, int ldb, double *dst, int K, int N, int NR, int numThreads) {
+    const int panels = (N + NR - 1) / NR;
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int q = 0; q < panels; ++q) {
+        double *d = dst + (long) q * NR * K;
+        const int j0 = q * NR;
+        const int w  = N - j0 < NR ? N - j0 : NR;
+        for (int k = 0; k < K; ++k) {
+            const double *s = B + (long) k * ldb + j0;
+            #pragma omp simd
+            for (int c = 0; c < w; ++c) d[(long) k * NR + c] = s[c];
+            for (int c = w; c < NR; ++c) d[(long) k * NR + c] = 0.0;
+        }
+    }
+}
+
+#endif // TRANSPOSE_H
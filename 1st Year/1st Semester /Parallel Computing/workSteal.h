@@ -0,0 +1,231 @@
+#ifndef WORK_STEAL_H
+#define WORK_STEAL_H
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <algorithm> // para std::min
+
+#include <stdio.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// ------------------------------------------------------------
+// Escalonador com work stealing sobre std::thread
+// Cada thread tem a sua própria deque de tarefas (ex: índices de tiles de C).
+// Inicialmente as tarefas são distribuídas em blocos contíguos (como a
+// partição estática do matrixMultV2.cpp), o que preserva a localidade.
+// - o dono retira tarefas da frente da sua deque (ordem natural das linhas)
+// - uma thread sem trabalho rouba metade das tarefas do fim da deque de outra
+// Assim, uma thread lenta (nó partilhado, oversubscription) deixa de
+// atrasar a multiplicação inteira: as outras ficam com o trabalho dela.
+// ------------------------------------------------------------
+
+// alignas(64) para cada deque ficar na sua cache line (sem false sharing)
+struct alignas(64) WorkQueue {
+    std::mutex mtx;
+    std::deque<int> tasks;
+};
+
+struct StealStats {
+    std::vector<int> executed; // tarefas executadas por cada thread
+    std::vector<int> stolen;   // tarefas roubadas por cada thread
+};
+
+// Retira uma tarefa da frente da própria deque; devolve -1 se estiver vazia
+inline int popTask(WorkQueue &q) {
+    std::lock_guard<std::mutex> lock(q.mtx);
+    if (q.tasks.empty()) return -1;
+    int t = q.tasks.front();
+    q.tasks.pop_front();
+    return t;
+}
+
+// Rouba metade (pelo menos uma) das tarefas do fim da deque da vítima e
+// coloca-as na deque do ladrão. Devolve o número de tarefas roubadas.
+inline int stealTasks(WorkQueue &victim, WorkQueue &thief) {
+    std::deque<int> loot;
+    {
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        int n = (int) victim.tasks.size();
+        if (n == 0) return 0;
+        int take = std::max(1, n / 2);
+        loot.assign(victim.tasks.end() - take, victim.tasks.end());
+        victim.tasks.erase(victim.tasks.end() - take, victim.tasks.end());
+    }
+    std::lock_guard<std::mutex> lock(thief.mtx);
+    thief.tasks.insert(thief.tasks.end(), loot.begin(), loot.end());
+    return (int) loot.size();
+}
+
+// ------------------------------------------------------------
+// Afinidade das std::threads
+// As std::threads não são fixadas pelo OpenMP (OMP_PROC_BIND só trata da
+// pool OpenMP) e herdam a máscara de quem as cria: com OMP_PROC_BIND=true a
+// thread principal fica presa a um só core, e todas as std::threads criadas
+// por ela ficariam nesse mesmo core.
+//
+// Política: as std::threads seguem o OpenMP. Só são fixadas se o OpenMP
+// também fixar as suas threads (bindThreads()), e nesse caso a thread id vai
+// para o mesmo place que a thread OpenMP id teria (omp_get_place_proc_ids),
+// o que também substitui a máscara herdada. Sem places (nada pedido), não se
+// fixa nada e o SO distribui as threads, como faz com a pool OpenMP.
+// Com a thread id no mesmo place no first touch e no cálculo, as páginas que
+// ela toca ficam no nó NUMA onde vão ser usadas.
+// ------------------------------------------------------------
+
+// true se o OpenMP estiver a fixar threads (OMP_PROC_BIND/OMP_PLACES)
+inline bool bindThreads() {
+#ifdef _OPENMP
+    return omp_get_proc_bind() != omp_proc_bind_false && omp_get_num_places() > 0;
+#else
+    return false;
+#endif
+}
+
+#ifdef __linux__
+// CPUs de cada slot, calculados uma vez: um slot por place OpenMP; sem places,
+// um slot por CPU da máscara do processo (cpuset do SLURM, taskset, ...)
+inline const std::vector<cpu_set_t> &pinSlots() {
+    static const std::vector<cpu_set_t> slots = []() {
+        std::vector<cpu_set_t> v;
+#ifdef _OPENMP
+        for (int p = 0; p < omp_get_num_places(); p++) {
+            std::vector<int> ids(omp_get_place_num_procs(p));
+            omp_get_place_proc_ids(p, ids.data());
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : ids) CPU_SET(cpu, &set);
+            if (!ids.empty()) v.push_back(set);
+        }
+#endif
+        if (v.empty()) {
+            cpu_set_t allowed;
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    if (!CPU_ISSET(cpu, &allowed)) continue;
+                    cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(cpu, &set);
+                    v.push_back(set);
+                }
+            }
+        }
+        return v;
+    }();
+    return slots;
+}
+#endif
+
+// Fixa a thread atual no slot id (módulo o nº de slots). Devolve false (e
+// avisa uma vez) se não conseguir; a thread fica com a máscara que tinha.
+inline bool pinThread(int id) {
+#ifdef __linux__
+    const std::vector<cpu_set_t> &slots = pinSlots();
+    if (slots.empty()) return false;
+    const cpu_set_t &set = slots[id % slots.size()];
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) { // 0 = thread atual
+        static std::once_flag warned;
+        std::call_once(warned, [id]() {
+            fprintf(stderr, "pinThread: could not pin thread %d, it keeps the inherited mask\n", id);
+        });
+        return false;
+    }
+    return true;
+#else
+    (void) id;
+    return false;
+#endif
+}
+
+// Bloco contíguo inicial de tarefas [start, end) da thread id
+// (a mesma partição do matrixMultV2.cpp; a última thread fica com o resto)
+inline void taskChunk(int id, int numTasks, int numThreads, int &start, int &end) {
+    int chunk = numTasks / numThreads;
+    start = id * chunk;
+    end   = (id == numThreads - 1) ? numTasks : start + chunk;
+}
+
+// First touch com std::threads organizadas como as do runWorkStealing():
+// a thread id chama touch(tarefa) para o seu bloco inicial, ou seja as
+// tarefas que vai executar enquanto não houver roubos. Com pin, as threads
+// ficam no mesmo slot que os workers com o mesmo id (use o mesmo valor nos
+// dois). Tem de correr antes de qualquer escrita nas matrizes.
+template <typename Touch>
+void touchTasks(int numTasks, int numThreads, Touch touch, bool pin = false) {
+    std::vector<std::thread> tx;
+    tx.reserve(numThreads);
+    for (int id = 0; id < numThreads; id++) {
+        tx.emplace_back([&, id]() {
+            if (pin) pinThread(id);
+            int start, end;
+            taskChunk(id, numTasks, numThreads, start, end);
+            for (int t = start; t < end; t++) touch(t);
+        });
+    }
+    for (auto &t : tx) t.join();
+}
+
+// Executa work(tarefa, threadID) para todas as tarefas 0..numTasks-1
+// usando numThreads std::threads com work stealing.
+// Como não são criadas tarefas novas durante a execução, uma thread pode
+// terminar assim que encontrar todas as deques vazias.
+// Com pin, o worker id fixa-se com pinThread(id) (ex: pin = bindThreads()).
+template <typename Work>
+StealStats runWorkStealing(int numTasks, int numThreads, Work work, bool pin = false) {
+    std::vector<WorkQueue> queues(numThreads);
+    StealStats stats;
+    stats.executed.assign(numThreads, 0);
+    stats.stolen.assign(numThreads, 0);
+
+    for (int id = 0; id < numThreads; id++) {
+        int start, end;
+        taskChunk(id, numTasks, numThreads, start, end);
+        for (int t = start; t < end; t++)
+            queues[id].tasks.push_back(t);
+    }
+
+    auto worker = [&](int id) {
+        if (pin) pinThread(id);
+        // Contadores locais: escrever no vetor partilhado em cada tarefa
+        // punha as threads a disputar a mesma cache line (false sharing)
+        int executed = 0, stolen = 0;
+        while (true) {
+            int t = popTask(queues[id]);
+            if (t >= 0) {
+                work(t, id);
+                executed++;
+                continue;
+            }
+
+            // Deque vazia: procura uma vítima, começando pela thread seguinte
+            int got = 0;
+            for (int v = 1; v < numThreads && got == 0; v++)
+                got = stealTasks(queues[(id + v) % numThreads], queues[id]);
+
+            if (got == 0) break; // todas as deques vazias: terminou
+            stolen += got;
+        }
+        stats.executed[id] = executed;
+        stats.stolen[id] = stolen;
+    };
+
+    std::vector<std::thread> tx;
+    tx.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++)
+        tx.emplace_back(worker, i);
+
+    for (int i = 0; i < numThreads; i++)
+        tx[i].join();
+
+    return stats;
+}
+
+#endif // WORK_STEAL_H